@@ -0,0 +1,85 @@
+// 任务池.h
+// 固定数量工作线程的任务池: 提交的任务按先进先出执行
+// 析构时先执行完已提交的任务再退出, 已发出的 future 不会悬空
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class 任务池 {
+public:
+  using 任务 = std::move_only_function<void()>;
+
+  explicit 任务池(std::size_t 线程数 = std::thread::hardware_concurrency()) {
+    线程数 = std::max<std::size_t>(线程数, 1);
+    工作线程.reserve(线程数);
+    for (std::size_t i = 0; i < 线程数; ++i)
+      工作线程.emplace_back([this] { 运行(); });
+  }
+
+  ~任务池() {
+    {
+      std::lock_guard 守卫(锁);
+      停止 = true;
+    }
+    有任务.notify_all();
+    // jthread 析构时自动 join
+  }
+
+  任务池(const 任务池 &) = delete;
+  任务池 &operator=(const 任务池 &) = delete;
+
+  // 任务抛出的异常会被吞掉; 需要结果或异常时用 异步()
+  void 提交(任务 新任务) {
+    {
+      std::lock_guard 守卫(锁);
+      队列.push_back(std::move(新任务));
+    }
+    有任务.notify_one();
+  }
+
+  template <typename 函数类型>
+  auto 异步(函数类型 &&函数) -> std::future<std::invoke_result_t<函数类型 &>> {
+    using 结果类型 = std::invoke_result_t<函数类型 &>;
+    std::packaged_task<结果类型()> 打包(std::forward<函数类型>(函数));
+    auto 结果 = 打包.get_future();
+    提交(std::move(打包));
+    return 结果;
+  }
+
+  std::size_t 线程数() const { return 工作线程.size(); }
+
+private:
+  std::mutex 锁;
+  std::condition_variable 有任务;
+  std::deque<任务> 队列;
+  bool 停止 = false;
+  std::vector<std::jthread> 工作线程; // 最后声明, 最先析构
+
+  void 运行() {
+    for (;;) {
+      任务 当前;
+      {
+        std::unique_lock 守卫(锁);
+        有任务.wait(守卫, [this] { return 停止 || !队列.empty(); });
+        if (队列.empty())
+          return; // 只有停止且队列已空时才退出
+        当前 = std::move(队列.front());
+        队列.pop_front();
+      }
+      try {
+        当前();
+      } catch (...) {
+      }
+    }
+  }
+};
@@ -0,0 +1,56 @@
+// 写时复制.h
+// 写时复制句柄: 复制句柄只增加引用计数, 多个句柄共享同一份只读数据
+// 第一次写入时, 若数据仍被共享, 先复制一份独占的再写
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+template <typename 数据类型> class 写时复制 {
+public:
+  写时复制() : 块(new 共享块{}) {}
+  explicit 写时复制(数据类型 值) : 块(new 共享块{{1}, std::move(值)}) {}
+
+  写时复制(const 写时复制 &其他) noexcept : 块(其他.块) {
+    块->引用.fetch_add(1, std::memory_order_relaxed);
+  }
+  写时复制(写时复制 &&其他) noexcept : 块(std::exchange(其他.块, nullptr)) {}
+  写时复制 &operator=(写时复制 其他) noexcept {
+    std::swap(块, 其他.块);
+    return *this;
+  }
+  ~写时复制() { 释放(块); }
+
+  // 被移动后的句柄只能销毁或重新赋值
+  const 数据类型 &读() const { return 块->值; }
+  const 数据类型 *operator->() const { return &块->值; }
+
+  // 返回独占数据的可写引用; 引用在下一次复制句柄之前有效
+  数据类型 &写() {
+    // acquire 与其他句柄释放时的 release 配对, 看到 1 时它们的读取都已结束
+    if (块->引用.load(std::memory_order_acquire) != 1) {
+      共享块 *独占 = new 共享块{{1}, 块->值};
+      释放(std::exchange(块, 独占));
+    }
+    return 块->值;
+  }
+
+  bool 共享中() const {
+    return 块->引用.load(std::memory_order_relaxed) > 1;
+  }
+
+private:
+  // 引用计数与数据同在一次分配中, 句柄本身只占一个指针
+  struct 共享块 {
+    std::atomic<std::uint32_t> 引用{1};
+    数据类型 值{};
+  };
+
+  共享块 *块;
+
+  static void 释放(共享块 *目标) {
+    if (目标 && 目标->引用.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete 目标;
+  }
+};
@@ -0,0 +1,70 @@
+// 单生产单消费队列.h
+// 有界无锁环形队列: 恰好一个生产者线程和一个消费者线程
+// 读写位置各占一条缓存行, 生产者和消费者互不干扰
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+
+template <typename 元素类型> class 单生产单消费队列 {
+public:
+  // 容量向上取整为 2 的幂
+  explicit 单生产单消费队列(std::size_t 容量)
+      : 容量(std::bit_ceil(容量 > 0 ? 容量 : 1)),
+        缓冲(std::make_unique<元素类型[]>(this->容量)) {}
+
+  单生产单消费队列(const 单生产单消费队列 &) = delete;
+  单生产单消费队列 &operator=(const 单生产单消费队列 &) = delete;
+
+  // 仅生产者调用; 队列已满时返回 false, 值保持不变
+  bool 压入(元素类型 &值) {
+    auto 写 = 写位置.load(std::memory_order_relaxed);
+    if (写 - 读位置缓存 == 容量) {
+      读位置缓存 = 读位置.load(std::memory_order_acquire);
+      if (写 - 读位置缓存 == 容量)
+        return false;
+    }
+    缓冲[写 & (容量 - 1)] = std::move(值);
+    写位置.store(写 + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool 压入(元素类型 &&值) { return 压入(值); }
+
+  // 仅消费者调用; 队列为空时返回 std::nullopt
+  std::optional<元素类型> 弹出() {
+    auto 读 = 读位置.load(std::memory_order_relaxed);
+    if (读 == 写位置缓存) {
+      写位置缓存 = 写位置.load(std::memory_order_acquire);
+      if (读 == 写位置缓存)
+        return std::nullopt;
+    }
+    std::optional<元素类型> 结果(std::move(缓冲[读 & (容量 - 1)]));
+    读位置.store(读 + 1, std::memory_order_release);
+    return 结果;
+  }
+
+  // 任意线程可调用, 结果只是近似值
+  std::size_t 大小() const {
+    return 写位置.load(std::memory_order_acquire) -
+           读位置.load(std::memory_order_acquire);
+  }
+
+  std::size_t 最大容量() const { return 容量; }
+
+private:
+  const std::size_t 容量;
+  std::unique_ptr<元素类型[]> 缓冲;
+
+  // 生产者独占: 写位置及其看到的读位置快照
+  alignas(64) std::atomic<std::size_t> 写位置{0};
+  std::size_t 读位置缓存 = 0;
+
+  // 消费者独占: 读位置及其看到的写位置快照
+  alignas(64) std::atomic<std::size_t> 读位置{0};
+  std::size_t 写位置缓存 = 0;
+};
@@ -0,0 +1,123 @@
+// 只读文件映射.h
+// 把整个文件以只读方式映射进内存; 不支持映射的平台退回一次性读入
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#include <vector>
+#endif
+
+class 只读文件映射 {
+public:
+  // 文件不存在或无法映射时返回 std::nullopt
+  static std::optional<只读文件映射> 打开(const std::filesystem::path &路径) {
+    只读文件映射 映射;
+#if defined(_WIN32)
+    HANDLE 文件 = CreateFileW(路径.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (文件 == INVALID_HANDLE_VALUE)
+      return std::nullopt;
+    LARGE_INTEGER 大小{};
+    if (!GetFileSizeEx(文件, &大小)) {
+      CloseHandle(文件);
+      return std::nullopt;
+    }
+    映射.字节数 = static_cast<std::size_t>(大小.QuadPart);
+    if (映射.字节数 > 0) {
+      HANDLE 映射对象 =
+          CreateFileMappingW(文件, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (映射对象) {
+        映射.地址 = MapViewOfFile(映射对象, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(映射对象);
+      }
+    }
+    CloseHandle(文件);
+    if (映射.字节数 > 0 && !映射.地址)
+      return std::nullopt;
+#elif defined(__unix__) || defined(__APPLE__)
+    int 描述符 = ::open(路径.c_str(), O_RDONLY);
+    if (描述符 < 0)
+      return std::nullopt;
+    struct stat 状态{};
+    if (::fstat(描述符, &状态) != 0) {
+      ::close(描述符);
+      return std::nullopt;
+    }
+    映射.字节数 = static_cast<std::size_t>(状态.st_size);
+    if (映射.字节数 > 0) {
+      void *地址 =
+          ::mmap(nullptr, 映射.字节数, PROT_READ, MAP_PRIVATE, 描述符, 0);
+      映射.地址 = 地址 == MAP_FAILED ? nullptr : 地址;
+    }
+    ::close(描述符); // 映射建立后即可关闭描述符
+    if (映射.字节数 > 0 && !映射.地址)
+      return std::nullopt;
+#else
+    std::ifstream 文件(路径, std::ios::binary);
+    if (!文件)
+      return std::nullopt;
+    映射.缓冲.assign(std::istreambuf_iterator<char>(文件), {});
+    映射.地址 = 映射.缓冲.data();
+    映射.字节数 = 映射.缓冲.size();
+#endif
+    return 映射;
+  }
+
+  只读文件映射(只读文件映射 &&其他) noexcept
+      : 地址(std::exchange(其他.地址, nullptr)),
+        字节数(std::exchange(其他.字节数, 0))
+#if !defined(_WIN32) && !defined(__unix__) && !defined(__APPLE__)
+        ,
+        缓冲(std::move(其他.缓冲))
+#endif
+  {
+  }
+  只读文件映射 &operator=(只读文件映射 &&其他) noexcept {
+    std::swap(地址, 其他.地址);
+    std::swap(字节数, 其他.字节数);
+#if !defined(_WIN32) && !defined(__unix__) && !defined(__APPLE__)
+    std::swap(缓冲, 其他.缓冲);
+#endif
+    return *this;
+  }
+  只读文件映射(const 只读文件映射 &) = delete;
+  只读文件映射 &operator=(const 只读文件映射 &) = delete;
+
+  ~只读文件映射() {
+    if (!地址)
+      return;
+#if defined(_WIN32)
+    UnmapViewOfFile(地址);
+#elif defined(__unix__) || defined(__APPLE__)
+    ::munmap(地址, 字节数);
+#endif
+  }
+
+  std::span<const std::byte> 内容() const {
+    return {static_cast<const std::byte *>(地址), 字节数};
+  }
+
+private:
+  只读文件映射() = default;
+
+  void *地址 = nullptr;
+  std::size_t 字节数 = 0;
+#if !defined(_WIN32) && !defined(__unix__) && !defined(__APPLE__)
+  std::vector<char> 缓冲;
+#endif
+};
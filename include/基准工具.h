@@ -0,0 +1,55 @@
+// 基准工具.h
+// 各模式性能测试共用的计时、防优化与内存统计工具
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+#if defined(_WIN32)
+#include <windows.h>
+// windows.h 之后才能包含 psapi.h
+#include <psapi.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+using 基准时钟 = std::chrono::steady_clock;
+
+// 返回执行一次 函数 所用的秒数
+template <typename 函数类型> double 基准计时(函数类型 &&函数) {
+  auto 开始 = 基准时钟::now();
+  函数();
+  std::chrono::duration<double> 用时 = 基准时钟::now() - 开始;
+  return 用时.count();
+}
+
+// 让编译器认为 值 被使用, 防止基准中的计算被整体优化掉
+template <typename 类型> inline void 防止优化(const 类型 &值) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(值) : "memory");
+#else
+  static const void *volatile 汇点;
+  汇点 = &值;
+#endif
+}
+
+// 当前进程的常驻内存 (RSS), 单位字节; 不支持的平台返回 0
+inline std::size_t 常驻内存字节() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS 计数{};
+  GetProcessMemoryInfo(GetCurrentProcess(), &计数, sizeof(计数));
+  return 计数.WorkingSetSize;
+#elif defined(__linux__)
+  long 总页数 = 0, 常驻页数 = 0;
+  if (std::FILE *文件 = std::fopen("/proc/self/statm", "r")) {
+    if (std::fscanf(文件, "%ld %ld", &总页数, &常驻页数) != 2)
+      常驻页数 = 0;
+    std::fclose(文件);
+  }
+  return static_cast<std::size_t>(常驻页数) *
+         static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,72 @@
+// 延迟直方图.h
+// 对数分桶的延迟直方图: 每个 2 的幂区间再等分 8 份, 相对误差不超过 12.5%
+// 记录只是一次数组自增, 适合放在每帧的热路径上; 不是线程安全的
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+class 延迟直方图 {
+public:
+  void 记录(std::uint64_t 纳秒) {
+    ++桶[桶号(纳秒)];
+    ++总次数;
+    最大值 = std::max(最大值, 纳秒);
+  }
+
+  void 合并(const 延迟直方图 &其他) {
+    for (std::size_t i = 0; i < 桶.size(); ++i)
+      桶[i] += 其他.桶[i];
+    总次数 += 其他.总次数;
+    最大值 = std::max(最大值, 其他.最大值);
+  }
+
+  void 清空() { *this = 延迟直方图{}; }
+
+  std::uint64_t 次数() const { return 总次数; }
+  std::uint64_t 最大() const { return 最大值; }
+
+  // 比例 取 0..1, 返回所在桶的上界 (不超过实际最大值); 没有记录时返回 0
+  std::uint64_t 分位数(double 比例) const {
+    if (总次数 == 0)
+      return 0;
+    auto 目标 = static_cast<std::uint64_t>(比例 * static_cast<double>(总次数));
+    目标 = std::clamp<std::uint64_t>(目标, 1, 总次数);
+    std::uint64_t 累计 = 0;
+    for (std::size_t i = 0; i < 桶.size(); ++i) {
+      累计 += 桶[i];
+      if (累计 >= 目标)
+        return std::min(桶上界(i), 最大值);
+    }
+    return 最大值;
+  }
+
+private:
+  static constexpr int 细分位数 = 3; // 每个 2 的幂区间 8 个桶
+  static constexpr std::size_t 细分 = std::size_t{1} << 细分位数;
+
+  std::array<std::uint64_t, (64 - 细分位数 + 1) * 细分> 桶{};
+  std::uint64_t 总次数 = 0;
+  std::uint64_t 最大值 = 0;
+
+  // 小于 8 的值各占一桶; 更大的值按最高位所在区间和其后 3 位分桶
+  static std::size_t 桶号(std::uint64_t 值) {
+    if (值 < 细分)
+      return static_cast<std::size_t>(值);
+    int 指数 = std::bit_width(值) - 1;
+    auto 子桶 = static_cast<std::size_t>((值 >> (指数 - 细分位数)) & (细分 - 1));
+    return static_cast<std::size_t>(指数 - 细分位数 + 1) * 细分 + 子桶;
+  }
+
+  static std::uint64_t 桶上界(std::size_t 号) {
+    if (号 < 细分)
+      return 号;
+    std::size_t 指数 = 号 / 细分 + 细分位数 - 1;
+    std::uint64_t 子桶 = 号 % 细分;
+    std::uint64_t 下界 = (细分 + 子桶) << (指数 - 细分位数);
+    return 下界 + (std::uint64_t{1} << (指数 - 细分位数)) - 1;
+  }
+};
@@ -0,0 +1,74 @@
+// 计数随机数.h
+// 基于计数器的随机数 (Squares, Widynski 2020): 第 n 个随机数只取决于 (n, 密钥),
+// 没有需要串行推进的全局状态. 因此可以按 (实体, 帧) 直接定位,
+// 多线程分段生成与单线程生成的结果完全一致, 批量生成的循环也没有依赖链
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+class 计数随机数 {
+public:
+  // 由任意种子 (例如实体编号) 派生密钥: splitmix64 打散后置为奇数
+  static constexpr std::uint64_t 派生密钥(std::uint64_t 种子) {
+    种子 += 0x9e3779b97f4a7c15ull;
+    种子 = (种子 ^ (种子 >> 30)) * 0xbf58476d1ce4e5b9ull;
+    种子 = (种子 ^ (种子 >> 27)) * 0x94d049bb133111ebull;
+    return (种子 ^ (种子 >> 31)) | 1;
+  }
+
+  // Squares 四轮平方, 返回 32 位随机数; 纯函数, 可在任意线程调用
+  static constexpr std::uint32_t 生成(std::uint64_t 计数, std::uint64_t 密钥) {
+    std::uint64_t x = 计数 * 密钥, y = x, z = y + 密钥;
+    x = x * x + y;
+    x = (x >> 32) | (x << 32);
+    x = x * x + z;
+    x = (x >> 32) | (x << 32);
+    x = x * x + y;
+    x = (x >> 32) | (x << 32);
+    return static_cast<std::uint32_t>((x * x + z) >> 32);
+  }
+
+  // 把 32 位随机数映射到 [下限, 上限) (乘法取高位, 偏差可忽略)
+  static constexpr int 映射范围(std::uint32_t 随机值, int 下限, int 上限) {
+    auto 跨度 = static_cast<std::uint64_t>(static_cast<std::int64_t>(上限) - 下限);
+    return 下限 + static_cast<int>((随机值 * 跨度) >> 32);
+  }
+
+  constexpr explicit 计数随机数(std::uint64_t 种子, std::uint64_t 起始计数 = 0)
+      : 密钥(派生密钥(种子)), 计数(起始计数) {}
+
+  // 某个实体在某一帧的随机流: 高 32 位为帧号, 低 32 位为帧内第几次掷骰
+  static constexpr 计数随机数 按实体帧(std::uint64_t 实体, std::uint32_t 帧) {
+    return 计数随机数(实体, static_cast<std::uint64_t>(帧) << 32);
+  }
+
+  constexpr std::uint32_t operator()() { return 生成(计数++, 密钥); }
+
+  // [下限, 上限) 内的整数
+  constexpr int 范围(int 下限, int 上限) {
+    return 映射范围((*this)(), 下限, 上限);
+  }
+
+  // 批量接口: 各元素互不依赖, 编译器可以向量化; 调用后计数前进 输出.size()
+  constexpr void 批量填充(std::span<std::uint32_t> 输出) {
+    for (std::size_t i = 0; i < 输出.size(); ++i)
+      输出[i] = 生成(计数 + i, 密钥);
+    计数 += 输出.size();
+  }
+
+  constexpr void 批量范围(std::span<int> 输出, int 下限, int 上限) {
+    for (std::size_t i = 0; i < 输出.size(); ++i)
+      输出[i] = 映射范围(生成(计数 + i, 密钥), 下限, 上限);
+    计数 += 输出.size();
+  }
+
+  // 直接跳到第 n 个随机数, O(1)
+  constexpr void 定位(std::uint64_t 新计数) { 计数 = 新计数; }
+  constexpr std::uint64_t 当前计数() const { return 计数; }
+
+private:
+  std::uint64_t 密钥;
+  std::uint64_t 计数;
+};
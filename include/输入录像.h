@@ -0,0 +1,202 @@
+// 输入录像.h
+// 逐帧输入录像: 每帧一个字节 (动作位掩码、按键字符等)
+// 与上一帧异或得到变化, 再对不变的帧做游程编码: 空闲帧不占空间,
+// 每次变化只占 1 字节加上之前保持帧数的变长整数
+#pragma once
+
+#include "只读文件映射.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// 文件格式 (本机字节序): 文件头 | 记录...
+// 每条记录: 保持帧数 (LEB128 变长整数) | 变化 (1 字节, 与上一值异或)
+// 含义: 先重复当前值 保持帧数 帧, 再异或 变化 得到下一帧的值; 初始值为 0
+// 最后一次变化之后的帧不写记录, 由文件头中的总帧数补齐
+namespace 输入录像格式 {
+
+inline constexpr char 魔数[8] = {'S', 'R', 'L', 'X', 'L', 'X', 0, 1};
+inline constexpr std::uint32_t 版本 = 1;
+
+struct 文件头 {
+  char 魔数[8];
+  std::uint32_t 版本;
+  std::uint32_t 保留;
+  std::uint64_t 帧数;
+  std::uint64_t 载荷字节;
+};
+
+} // namespace 输入录像格式
+
+class 输入录像 {
+public:
+  // 录制一帧
+  void 追加(std::uint8_t 值) {
+    ++总帧数;
+    if (值 == 末值) {
+      ++待保持;
+      return;
+    }
+    写变长(待保持);
+    载荷.push_back(static_cast<std::byte>(值 ^ 末值));
+    末值 = 值;
+    待保持 = 0;
+  }
+
+  std::uint64_t 帧数() const { return 总帧数; }
+  // 已编码的字节数, 不含文件头
+  std::size_t 编码字节() const { return 载荷.size(); }
+
+  void 清空() { *this = 输入录像{}; }
+
+  // 按帧解码; 读取器引用录像的缓冲, 录像在回放期间不能再追加
+  class 读取器 {
+  public:
+    explicit 读取器(const 输入录像 &来源)
+        : 载荷(来源.载荷), 总帧数(来源.总帧数) {
+      读记录();
+    }
+
+    bool 结束() const { return 已读 == 总帧数; }
+    std::uint64_t 位置() const { return 已读; }
+
+    // 结束后继续调用时一直返回最后的值
+    std::uint8_t 下一帧() {
+      if (结束())
+        return 值;
+      ++已读;
+      if (剩余保持 > 0) {
+        --剩余保持;
+      } else if (有变化) {
+        值 ^= 变化;
+        读记录();
+      }
+      return 值;
+    }
+
+  private:
+    std::span<const std::byte> 载荷;
+    std::size_t 游标 = 0;
+    std::uint64_t 总帧数;
+    std::uint64_t 已读 = 0;
+    std::uint64_t 剩余保持 = 0;
+    std::uint8_t 值 = 0;
+    std::uint8_t 变化 = 0;
+    bool 有变化 = false;
+
+    void 读记录() {
+      有变化 = 游标 < 载荷.size();
+      if (!有变化)
+        return;
+      剩余保持 = 读变长(载荷, 游标);
+      变化 = static_cast<std::uint8_t>(载荷[游标++]);
+    }
+  };
+
+  读取器 回放() const { return 读取器(*this); }
+
+  // 逐帧比较两段录像, 返回第一个不同的帧号; 完全相同时返回 std::nullopt
+  // 帧数不同时, 较短录像结束后的第一帧视为不同
+  static std::optional<std::uint64_t> 首个差异帧(const 输入录像 &甲,
+                                                 const 输入录像 &乙) {
+    auto 读甲 = 甲.回放(), 读乙 = 乙.回放();
+    while (!读甲.结束() && !读乙.结束()) {
+      std::uint64_t 帧 = 读甲.位置();
+      if (读甲.下一帧() != 读乙.下一帧())
+        return 帧;
+    }
+    if (读甲.结束() && 读乙.结束())
+      return std::nullopt;
+    return 读甲.位置();
+  }
+
+  // 先写临时文件再改名; 失败时抛出 std::runtime_error
+  void 保存(const std::filesystem::path &文件) const {
+    using namespace 输入录像格式;
+    文件头 头{};
+    std::memcpy(头.魔数, 魔数, sizeof 魔数);
+    头.版本 = 版本;
+    头.帧数 = 总帧数;
+    头.载荷字节 = 载荷.size();
+
+    auto 临时文件 = 文件;
+    临时文件 += ".tmp";
+    {
+      std::ofstream 输出(临时文件, std::ios::binary | std::ios::trunc);
+      输出.write(reinterpret_cast<const char *>(&头), sizeof 头);
+      输出.write(reinterpret_cast<const char *>(载荷.data()),
+                 static_cast<std::streamsize>(载荷.size()));
+      if (!输出)
+        throw std::runtime_error("无法写入输入录像: " + 临时文件.string());
+    }
+    std::filesystem::rename(临时文件, 文件);
+  }
+
+  // 文件缺失、格式不符或记录越界时抛出 std::runtime_error
+  static 输入录像 载入(const std::filesystem::path &文件) {
+    using namespace 输入录像格式;
+    auto 映射 = 只读文件映射::打开(文件);
+    if (!映射)
+      throw std::runtime_error("无法打开输入录像: " + 文件.string());
+    auto 内容 = 映射->内容();
+    文件头 头;
+    if (内容.size() < sizeof 头)
+      throw std::runtime_error("输入录像过短: " + 文件.string());
+    std::memcpy(&头, 内容.data(), sizeof 头);
+    if (std::memcmp(头.魔数, 魔数, sizeof 魔数) != 0 || 头.版本 != 版本 ||
+        头.载荷字节 != 内容.size() - sizeof 头)
+      throw std::runtime_error("输入录像格式不符: " + 文件.string());
+
+    输入录像 录像;
+    录像.载荷.assign(内容.begin() + sizeof 头, 内容.end());
+    录像.总帧数 = 头.帧数;
+    // 逐条检查记录, 顺带恢复 末值 和 待保持, 载入后可以继续追加
+    std::size_t 游标 = 0;
+    std::uint64_t 已编码帧 = 0;
+    while (游标 < 录像.载荷.size()) {
+      std::uint64_t 保持 = 读变长(录像.载荷, 游标);
+      if (游标 >= 录像.载荷.size() || 保持 >= 头.帧数 - 已编码帧)
+        throw std::runtime_error("输入录像记录越界: " + 文件.string());
+      录像.末值 ^= static_cast<std::uint8_t>(录像.载荷[游标++]);
+      已编码帧 += 保持 + 1;
+    }
+    录像.待保持 = 头.帧数 - 已编码帧;
+    return 录像;
+  }
+
+private:
+  std::vector<std::byte> 载荷;
+  std::uint64_t 总帧数 = 0;
+  std::uint64_t 待保持 = 0; // 最后一次变化之后未写出的帧数
+  std::uint8_t 末值 = 0;
+
+  void 写变长(std::uint64_t 值) {
+    while (值 >= 0x80) {
+      载荷.push_back(static_cast<std::byte>(值 | 0x80));
+      值 >>= 7;
+    }
+    载荷.push_back(static_cast<std::byte>(值));
+  }
+
+  // 截断或超过 64 位的变长整数抛出 std::runtime_error
+  static std::uint64_t 读变长(std::span<const std::byte> 来源, std::size_t &游标) {
+    std::uint64_t 值 = 0;
+    for (int 移位 = 0; 移位 < 64; 移位 += 7) {
+      if (游标 >= 来源.size())
+        throw std::runtime_error("输入录像: 变长整数被截断");
+      auto 字节 = static_cast<std::uint8_t>(来源[游标++]);
+      值 |= std::uint64_t{字节 & 0x7Fu} << 移位;
+      if (!(字节 & 0x80))
+        return 值;
+    }
+    throw std::runtime_error("输入录像: 变长整数过长");
+  }
+};
@@ -1,18 +1,76 @@
 
 target("工厂模式")
   set_kind("binary")
+  add_includedirs("../../include")
   add_files("./工厂模式.cpp")
+  if is_plat("linux") then
+    add_syslinks("pthread")
+  end
+  -- 将武器定义文件复制到输出目录
+  after_build(function (target)
+    os.cp(path.join(os.scriptdir(), "武器定义.txt"), target:targetdir())
+  end)
+
+target("工厂模式基准")
+  set_kind("binary")
+  add_includedirs("./", "../../include")
+  add_files("./工厂模式基准.cpp")
+  if is_plat("windows") then
+    add_syslinks("psapi")
+  elseif is_plat("linux") then
+    add_syslinks("pthread")
+  end
 
 target("建造者模式")
   set_kind("binary")
+  add_includedirs("../../include")
   add_files("./建造者模式.cpp")
+  if is_plat("linux") then
+    add_syslinks("pthread")
+  end
+  -- 将角色原型文件复制到输出目录
+  after_build(function (target)
+    os.cp(path.join(os.scriptdir(), "角色原型.txt"), target:targetdir())
+  end)
+
+target("建造者模式基准")
+  set_kind("binary")
+  add_includedirs("./", "../../include")
+  add_files("./建造者模式基准.cpp")
+  if is_plat("windows") then
+    add_syslinks("psapi")
+  elseif is_plat("linux") then
+    add_syslinks("pthread")
+  end
 
 target("原型模式")
   set_kind("binary")
+  add_includedirs("./", "../../include")
   add_files("./原型模式.cpp")
 
+target("原型模式基准")
+  set_kind("binary")
+  add_includedirs("./", "../../include")
+  add_files("./原型模式基准.cpp")
+  if is_plat("windows") then
+    add_syslinks("psapi")
+  end
+
 target("单例模式")
   set_kind("binary")
-  add_includedirs("./")
+  add_includedirs("./", "../../include")
   add_files("./单例模式.cpp","./单例示例.cpp")
+  if is_plat("linux") then
+    add_syslinks("pthread")
+  end
+
+target("单例模式基准")
+  set_kind("binary")
+  add_includedirs("./", "../../include")
+  add_files("./单例模式基准.cpp", "./单例示例.cpp")
+  if is_plat("windows") then
+    add_syslinks("psapi")
+  elseif is_plat("linux") then
+    add_syslinks("pthread")
+  end
 
@@ -0,0 +1,87 @@
+// 分片单例.h
+// 按线程分片的单例: 每个线程写自己独占一条缓存行的分片, 需要全局结果时再归并
+// 适合统计计数、编号分配这类各线程高频写入、偶尔汇总读取的单例
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+// 用法与 单例对象 相同: class 统计 : public 分片单例<统计> { friend class 分片单例<统计>; ... };
+// 分片只由所属线程写入, 归并() 可能与写入同时进行,
+// 所以 类型 中会被归并读取的成员应使用 std::atomic (所属线程用 relaxed 读写即可)
+template <typename 类型> class 分片单例 {
+public:
+  // 热路径: 一次线程局部指针读取; 线程第一次访问时才分配或复用分片
+  static 类型 &本线程() {
+    分片 *当前 = 本线程分片;
+    if (!当前) [[unlikely]]
+      当前 = 领取分片();
+    return 当前->值;
+  }
+
+  // 按 函数(累计值, const 类型 &分片) -> 累计值 依次折叠所有分片, 包括已退出线程留下的
+  template <typename 结果类型, typename 归并函数类型>
+  static 结果类型 归并(结果类型 初值, 归并函数类型 &&函数) {
+    for (分片 *项 = 链表头.load(std::memory_order_acquire); 项; 项 = 项->下一个)
+      初值 = 函数(std::move(初值), std::as_const(项->值));
+    return 初值;
+  }
+
+  static std::size_t 分片数() {
+    std::size_t 数量 = 0;
+    for (分片 *项 = 链表头.load(std::memory_order_acquire); 项; 项 = 项->下一个)
+      ++数量;
+    return 数量;
+  }
+
+  分片单例(const 分片单例 &) = delete;
+  分片单例 &operator=(const 分片单例 &) = delete;
+
+protected:
+  分片单例() = default;
+
+private:
+  // 每个分片独占缓存行, 相邻线程的写入不会互相使对方的缓存行失效
+  struct alignas(64) 分片 {
+    类型 值;
+    分片 *下一个 = nullptr;
+    std::atomic<bool> 占用{true};
+  };
+
+  // 线程退出时把分片标记为空闲, 留给之后的新线程复用; 分片中的数据保留, 归并时仍计入
+  struct 归还器 {
+    分片 *目标 = nullptr;
+    ~归还器() {
+      if (目标)
+        目标->占用.store(false, std::memory_order_release);
+    }
+  };
+
+  // 分片只增不减, 进程退出时随进程回收; 链表只在头部插入, 遍历无需加锁
+  static constinit inline std::atomic<分片 *> 链表头{nullptr};
+  // 常量初始化且可平凡析构, 访问时不经过线程局部变量的初始化包装函数
+  static constinit inline thread_local 分片 *本线程分片 = nullptr;
+
+  static 分片 *领取分片() {
+    分片 *领到 = nullptr;
+    for (分片 *项 = 链表头.load(std::memory_order_acquire); 项 && !领到;
+         项 = 项->下一个) {
+      bool 期望 = false;
+      if (项->占用.compare_exchange_strong(期望, true,
+                                           std::memory_order_acquire))
+        领到 = 项;
+    }
+    if (!领到) {
+      领到 = new 分片{类型(), 链表头.load(std::memory_order_relaxed)};
+      while (!链表头.compare_exchange_weak(领到->下一个, 领到,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+      }
+    }
+    // 带析构函数的线程局部变量只在这条冷路径上出现
+    thread_local 归还器 退出时归还;
+    退出时归还.目标 = 领到;
+    本线程分片 = 领到;
+    return 领到;
+  }
+};
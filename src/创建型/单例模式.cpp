@@ -1,11 +1,40 @@
 
 #include "单例示例.h"
 
+#include <print>
+#include <thread>
+#include <vector>
+
 int main(int argc, char *argv[]) {
   // 单例模式
   游戏懒汉::实例化();
   游戏饿汉::实例.更新();
   游戏管理器::实例化();
 
+  // 显式单例: 启动时按依赖顺序统一初始化, 退出前按相反顺序关闭
+  单例注册表 注册表;
+  注册表.登记<场景管理器>("场景管理器"); // 登记先后不限
+  注册表.登记<资源管理器>("资源管理器");
+  注册表.登记<日志管理器>("日志管理器");
+  任务池 池(2);
+  注册表.初始化(池); // 互不依赖的单例在池中并行构造
+  for (const auto &记录 : 注册表.初始化记录())
+    std::println("{} 初始化耗时 {:.3f} ms", 记录.名称, 记录.耗时秒 * 1e3);
+  场景管理器::实例().更新();
+  std::println("场景管理器 帧数: {}", 场景管理器::实例().帧数);
+  注册表.关闭();
+
+  // 分片单例: 各线程写自己的分片, 读取时归并
+  std::vector<std::jthread> 线程组;
+  for (int 编号 = 0; 编号 < 4; ++编号)
+    线程组.emplace_back([编号] {
+      for (int 帧 = 0; 帧 < 1000; ++帧)
+        帧统计::本线程().记录帧(10 + 编号);
+    });
+  线程组.clear(); // 等待全部线程结束
+  auto 汇总 = 帧统计::全部();
+  std::println("帧统计: {} 个分片, {} 帧, {} 次绘制调用", 帧统计::分片数(),
+               汇总.帧数, 汇总.绘制调用数);
+
   return 0;
 }
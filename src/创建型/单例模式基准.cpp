@@ -0,0 +1,249 @@
+// 单例模式基准.cpp
+// 用法: 单例模式基准 [基准名]   不带参数时运行全部基准
+// 请在 release 模式下构建: xmake f -m release && xmake run 单例模式基准
+#include "基准工具.h"
+#include "单例示例.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <print>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t 访问次数 = 100'000'000;
+
+class 模板计数器 : public 单例对象<模板计数器> {
+  friend class 单例对象<模板计数器>;
+
+public:
+  std::uint64_t 次数 = 0;
+
+private:
+  模板计数器() {}
+};
+
+class 显式计数器 : public 显式单例<显式计数器> {
+  friend class ::单例注册表;
+
+public:
+  std::uint64_t 次数 = 0;
+
+private:
+  显式计数器() {}
+};
+
+// 取 5 次中最快的一次, 单次访问只有一两个时钟周期, 容易被调度噪声淹没
+template <typename 函数类型> void 报告(std::string_view 名称, 函数类型 &&函数) {
+  double 最短 = 基准计时(函数);
+  for (int 次 = 1; 次 < 5; ++次)
+    最短 = std::min(最短, 基准计时(函数));
+  std::println("  {:<28} {:>6.3f} ns/次", 名称, 最短 / 访问次数 * 1e9);
+}
+
+// 每次访问都读一次成员并 防止优化, 迫使编译器每轮重新取实例, 不能把访问提到循环外
+void 基准_访问() {
+  std::println("[访问] 每种方式访问 {} 次{}", 访问次数,
+#if defined(NDEBUG)
+               ""
+#else
+               " (含未初始化检查)"
+#endif
+  );
+  单例注册表 注册表;
+  注册表.登记<显式计数器>("显式计数器");
+  注册表.初始化();
+
+  报告("单例对象<T>::实例化()", [] {
+    for (std::size_t i = 0; i < 访问次数; ++i)
+      防止优化(模板计数器::实例化().次数);
+  });
+  报告("游戏懒汉::实例化() 跨翻译单元", [] {
+    for (std::size_t i = 0; i < 访问次数; ++i)
+      防止优化(&游戏懒汉::实例化());
+  });
+  报告("显式单例<T>::实例()", [] {
+    for (std::size_t i = 0; i < 访问次数; ++i)
+      防止优化(显式计数器::实例().次数);
+  });
+}
+
+// 构造时睡眠 毫秒, 模拟读文件、建连接等启动开销; 构造前检查依赖已经可用
+template <int 编号, int 毫秒, typename... 依赖类型>
+class 模拟单例 : public 显式单例<模拟单例<编号, 毫秒, 依赖类型...>> {
+  friend class ::单例注册表;
+
+public:
+  using 依赖 = 单例依赖<依赖类型...>;
+
+private:
+  模拟单例() {
+    if (!(依赖类型::可用() && ...))
+      throw std::logic_error("依赖尚未初始化");
+    std::this_thread::sleep_for(std::chrono::milliseconds(毫秒));
+  }
+};
+
+// 日志 -> 配置 -> {资源, 网络} -> {音频, 渲染, 物理} -> 场景 -> 界面
+using 模拟日志 = 模拟单例<0, 10>;
+using 模拟配置 = 模拟单例<1, 20, 模拟日志>;
+using 模拟资源 = 模拟单例<2, 60, 模拟配置>;
+using 模拟网络 = 模拟单例<3, 50, 模拟配置>;
+using 模拟音频 = 模拟单例<4, 40, 模拟资源>;
+using 模拟渲染 = 模拟单例<5, 80, 模拟资源>;
+using 模拟物理 = 模拟单例<6, 30, 模拟配置>;
+using 模拟场景 = 模拟单例<7, 20, 模拟音频, 模拟渲染, 模拟物理>;
+using 模拟界面 = 模拟单例<8, 30, 模拟场景, 模拟网络>;
+
+void 登记模拟单例(单例注册表 &注册表) {
+  注册表.登记<模拟界面>("界面");
+  注册表.登记<模拟场景>("场景");
+  注册表.登记<模拟物理>("物理");
+  注册表.登记<模拟渲染>("渲染");
+  注册表.登记<模拟音频>("音频");
+  注册表.登记<模拟网络>("网络");
+  注册表.登记<模拟资源>("资源");
+  注册表.登记<模拟配置>("配置");
+  注册表.登记<模拟日志>("日志");
+}
+
+void 打印记录(const 单例注册表 &注册表) {
+  for (const auto &记录 : 注册表.初始化记录())
+    std::println("    {:<4} 开始 {:>6.1f} ms  耗时 {:>5.1f} ms", 记录.名称,
+                 记录.开始秒 * 1e3, 记录.耗时秒 * 1e3);
+}
+
+// 9 个单例构造共睡眠 340 ms, 依赖链最长 10+20+60+80+20+30 = 220 ms
+void 基准_并行启动() {
+  std::println("[并行启动] 9 个单例, 构造耗时合计 340 ms, 关键路径 220 ms");
+  单例注册表 注册表;
+  登记模拟单例(注册表);
+
+  注册表.初始化();
+  std::println("  逐个构造: 总耗时 {:.1f} ms", 注册表.初始化总秒() * 1e3);
+  打印记录(注册表);
+  注册表.关闭();
+
+  任务池 池(4);
+  注册表.初始化(池);
+  std::println("  任务池 4 线程: 总耗时 {:.1f} ms", 注册表.初始化总秒() * 1e3);
+  打印记录(注册表);
+  注册表.关闭();
+}
+
+constexpr std::size_t 每线程累加次数 = 2'000'000;
+
+class 共享计数器 : public 单例对象<共享计数器> {
+  friend class 单例对象<共享计数器>;
+
+public:
+  std::atomic<std::uint64_t> 次数{0};
+
+private:
+  共享计数器() {}
+};
+
+class 分片计数器 : public 分片单例<分片计数器> {
+  friend class 分片单例<分片计数器>;
+
+public:
+  void 加一() {
+    次数.store(次数.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+  }
+  static std::uint64_t 总数() {
+    return 归并(std::uint64_t{0}, [](std::uint64_t 和, const 分片计数器 &分片) {
+      return 和 + 分片.次数.load(std::memory_order_relaxed);
+    });
+  }
+
+private:
+  分片计数器() {}
+  std::atomic<std::uint64_t> 次数{0};
+};
+
+// 对照: 每线程一个计数器但紧挨着存放, 相邻线程写同一条缓存行 (伪共享)
+// 累加方式与 分片计数器::加一 相同, 两者只差在是否按缓存行隔开
+struct 紧凑计数 {
+  std::atomic<std::uint64_t> 次数{0};
+
+  void 加一() {
+    次数.store(次数.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+  }
+};
+紧凑计数 紧凑计数组[64];
+
+// 计时包含创建和等待线程, 每线程累加 200 万次, 线程创建开销可以忽略
+template <typename 函数类型>
+double 多线程计时(int 线程数, 函数类型 &&函数) {
+  return 基准计时([&] {
+    std::vector<std::jthread> 线程组;
+    for (int 编号 = 0; 编号 < 线程数; ++编号)
+      线程组.emplace_back(函数, 编号);
+  });
+}
+
+// 各线程每次累加都经过单例访问; 分片在线程退出后留给下一轮的线程复用
+void 基准_分片计数() {
+  std::println("[分片计数] 每线程累加 {} 次, 硬件线程 {}", 每线程累加次数,
+               std::thread::hardware_concurrency());
+  std::println("  {:>4} {:>14} {:>14} {:>14}", "线程", "共享原子 Mops/s",
+               "紧凑数组 Mops/s", "分片单例 Mops/s");
+  for (int 线程数 = 1; 线程数 <= 64; 线程数 *= 2) {
+    double 总次数 = static_cast<double>(线程数) * 每线程累加次数;
+
+    共享计数器::实例化().次数.store(0);
+    double 共享秒 = 多线程计时(线程数, [](int) {
+      for (std::size_t i = 0; i < 每线程累加次数; ++i)
+        共享计数器::实例化().次数.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    double 紧凑秒 = 多线程计时(线程数, [](int 编号) {
+      for (std::size_t i = 0; i < 每线程累加次数; ++i)
+        紧凑计数组[编号].加一();
+    });
+
+    std::uint64_t 之前 = 分片计数器::总数();
+    double 分片秒 = 多线程计时(线程数, [](int) {
+      for (std::size_t i = 0; i < 每线程累加次数; ++i)
+        分片计数器::本线程().加一();
+    });
+
+    if (共享计数器::实例化().次数.load() != 总次数 ||
+        分片计数器::总数() - 之前 != 总次数)
+      throw std::logic_error("计数结果不一致");
+    std::println("  {:>4} {:>14.1f} {:>14.1f} {:>14.1f}", 线程数,
+                 总次数 / 共享秒 / 1e6, 总次数 / 紧凑秒 / 1e6,
+                 总次数 / 分片秒 / 1e6);
+  }
+  std::println("  分片数 {} (线程退出后分片被复用)", 分片计数器::分片数());
+}
+
+struct 基准项 {
+  std::string_view 名称;
+  void (*函数)();
+};
+
+constexpr 基准项 全部基准[] = {
+    {"访问", 基准_访问},
+    {"并行启动", 基准_并行启动},
+    {"分片计数", 基准_分片计数},
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string_view 选择 = argc > 1 ? argv[1] : "";
+  for (const auto &项 : 全部基准) {
+    if (选择.empty() || 选择 == 项.名称)
+      项.函数();
+  }
+  return 0;
+}
@@ -0,0 +1,278 @@
+// 单例注册表.h
+// 显式初始化/关闭的单例: 启动阶段统一构造, 之后每次访问只是一次指针读取
+// 单例可以声明依赖, 注册表按依赖顺序构造 (可在任务池上并行), 按相反顺序析构
+#pragma once
+
+#include "任务池.h"
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class 单例注册表;
+
+// 与 单例对象 不同, 实例() 不含函数内静态变量的线程安全守卫检查,
+// 实例指针 是常量初始化的 inline 变量, 跨翻译单元也能内联成一次读取
+// 初始化() 完成后再启动的线程可以直接访问; 关闭() 前须停止所有访问线程
+template <typename 类型> class 显式单例 {
+public:
+  static 类型 &实例() {
+    assert(实例指针 && "单例在 单例注册表::初始化() 之前或 关闭() 之后被访问");
+    return *实例指针;
+  }
+  static bool 可用() { return 实例指针 != nullptr; }
+
+  显式单例(const 显式单例 &) = delete;
+  显式单例 &operator=(const 显式单例 &) = delete;
+
+protected:
+  显式单例() = default;
+
+private:
+  friend class 单例注册表;
+  static constinit inline 类型 *实例指针 = nullptr;
+};
+
+// 在单例类中声明 using 依赖 = 单例依赖<甲, 乙>; 构造函数运行时 甲 乙 已经可用
+template <typename... 类型> struct 单例依赖 {};
+
+struct 单例初始化记录 {
+  std::string_view 名称;
+  double 开始秒 = 0; // 相对 初始化() 开始的时刻
+  double 耗时秒 = 0;
+};
+
+// 按依赖顺序构造, 没有依赖关系的按登记顺序; 按实际构造完成的相反顺序析构
+// 注册表析构时自动关闭
+// 派生自 显式单例 的类型需把 单例注册表 声明为友元, 以便调用私有构造函数
+class 单例注册表 {
+public:
+  单例注册表() = default;
+  ~单例注册表() { 关闭(); }
+  单例注册表(const 单例注册表 &) = delete;
+  单例注册表 &operator=(const 单例注册表 &) = delete;
+
+  // 依赖的单例也必须在本注册表登记, 登记先后不限
+  template <typename 类型> void 登记(std::string_view 名称) {
+    if (已初始化)
+      throw std::logic_error("单例注册表: 初始化后不能再登记");
+    条目 新条目{名称, 键<类型>(),
+                [] {
+                  if (显式单例<类型>::实例指针)
+                    throw std::logic_error("单例已被其他注册表初始化");
+                  显式单例<类型>::实例指针 = new 类型();
+                },
+                [] {
+                  delete std::exchange(显式单例<类型>::实例指针, nullptr);
+                },
+                {}};
+    if constexpr (requires { typename 类型::依赖; })
+      收集依赖(新条目.依赖键, static_cast<typename 类型::依赖 *>(nullptr));
+    条目列表.push_back(std::move(新条目));
+  }
+
+  // 在调用线程上逐个构造
+  // 某个构造函数抛出异常时, 先析构已构造的单例再重新抛出
+  void 初始化() {
+    if (已初始化)
+      return;
+    auto 图 = 建立依赖图();
+    开始初始化();
+    try {
+      std::vector<std::size_t> 就绪;
+      for (std::size_t i = 0; i < 条目列表.size(); ++i)
+        if (图.入度[i] == 0)
+          就绪.push_back(i);
+      for (std::size_t 已处理 = 0; 已处理 < 就绪.size(); ++已处理) {
+        std::size_t 当前 = 就绪[已处理];
+        auto 开始 = 时钟::now();
+        条目列表[当前].构造();
+        记录完成(当前, 开始, 时钟::now());
+        for (std::size_t 后继 : 图.后继[当前])
+          if (--图.入度[后继] == 0)
+            就绪.push_back(后继);
+      }
+    } catch (...) {
+      关闭();
+      throw;
+    }
+    结束初始化();
+  }
+
+  // 在任务池上构造: 依赖都已就绪的单例同时开工
+  // 任一构造函数抛出异常后不再开工新的单例, 等进行中的结束后析构已构造的并重新抛出
+  // 不要在 池 的工作线程里调用, 否则可能等不到空闲线程
+  void 初始化(任务池 &池) {
+    if (已初始化)
+      return;
+    并行状态 状态(建立依赖图());
+    开始初始化();
+    std::vector<std::size_t> 就绪;
+    for (std::size_t i = 0; i < 条目列表.size(); ++i)
+      if (状态.图.入度[i] == 0)
+        就绪.push_back(i);
+    状态.进行中 = 就绪.size();
+    for (std::size_t i : 就绪)
+      开工(池, 状态, i);
+
+    std::unique_lock 守卫(状态.锁);
+    状态.全部结束.wait(守卫, [&] { return 状态.进行中 == 0; });
+    if (状态.错误) {
+      守卫.unlock();
+      关闭();
+      std::rethrow_exception(状态.错误);
+    }
+    结束初始化();
+  }
+
+  void 关闭() {
+    while (!构造顺序.empty()) {
+      条目列表[构造顺序.back()].析构();
+      构造顺序.pop_back();
+    }
+    已初始化 = false;
+  }
+
+  std::size_t 数量() const { return 条目列表.size(); }
+  std::string_view 名称(std::size_t 下标) const { return 条目列表[下标].名称; }
+
+  // 最近一次初始化中每个单例的起止时间, 按构造完成的先后排列
+  const std::vector<单例初始化记录> &初始化记录() const { return 记录列表; }
+  double 初始化总秒() const { return 总秒; }
+
+private:
+  using 时钟 = std::chrono::steady_clock;
+
+  struct 条目 {
+    std::string_view 名称;
+    const void *键;
+    void (*构造)();
+    void (*析构)();
+    std::vector<const void *> 依赖键;
+  };
+
+  struct 依赖图 {
+    std::vector<std::vector<std::size_t>> 后继;
+    std::vector<std::size_t> 入度;
+  };
+
+  struct 并行状态 {
+    explicit 并行状态(依赖图 初始图) : 图(std::move(初始图)) {}
+
+    依赖图 图;
+    std::mutex 锁;
+    std::condition_variable 全部结束;
+    std::size_t 进行中 = 0;
+    std::exception_ptr 错误;
+  };
+
+  std::vector<条目> 条目列表;
+  std::vector<std::size_t> 构造顺序; // 已构造的条目下标, 按完成先后
+  std::vector<单例初始化记录> 记录列表;
+  时钟::time_point 初始化开始;
+  double 总秒 = 0;
+  bool 已初始化 = false;
+
+  // 每个类型的实例指针地址唯一, 用作类型键, 不依赖 RTTI
+  template <typename 类型> static const void *键() {
+    return &显式单例<类型>::实例指针;
+  }
+
+  template <typename... 依赖类型>
+  static void 收集依赖(std::vector<const void *> &依赖键,
+                       单例依赖<依赖类型...> *) {
+    (依赖键.push_back(键<依赖类型>()), ...);
+  }
+
+  // 依赖未登记或成环时抛出 std::logic_error
+  依赖图 建立依赖图() const {
+    依赖图 图{std::vector<std::vector<std::size_t>>(条目列表.size()),
+              std::vector<std::size_t>(条目列表.size(), 0)};
+    for (std::size_t i = 0; i < 条目列表.size(); ++i) {
+      for (const void *依赖键 : 条目列表[i].依赖键) {
+        std::size_t j = 0;
+        while (j < 条目列表.size() && 条目列表[j].键 != 依赖键)
+          ++j;
+        if (j == 条目列表.size())
+          throw std::logic_error("单例 " + std::string(条目列表[i].名称) +
+                                 " 的依赖未登记");
+        图.后继[j].push_back(i);
+        ++图.入度[i];
+      }
+    }
+    // Kahn 拓扑排序检查环, 不修改 图
+    std::vector<std::size_t> 入度 = 图.入度, 就绪;
+    for (std::size_t i = 0; i < 入度.size(); ++i)
+      if (入度[i] == 0)
+        就绪.push_back(i);
+    for (std::size_t 已处理 = 0; 已处理 < 就绪.size(); ++已处理)
+      for (std::size_t 后继 : 图.后继[就绪[已处理]])
+        if (--入度[后继] == 0)
+          就绪.push_back(后继);
+    if (就绪.size() != 条目列表.size())
+      throw std::logic_error("单例依赖存在环");
+    return 图;
+  }
+
+  void 开始初始化() {
+    已初始化 = true;
+    记录列表.clear();
+    总秒 = 0;
+    初始化开始 = 时钟::now();
+  }
+
+  void 结束初始化() {
+    总秒 = std::chrono::duration<double>(时钟::now() - 初始化开始).count();
+  }
+
+  void 记录完成(std::size_t 下标, 时钟::time_point 开始,
+                时钟::time_point 结束) {
+    构造顺序.push_back(下标);
+    记录列表.push_back(
+        {条目列表[下标].名称,
+         std::chrono::duration<double>(开始 - 初始化开始).count(),
+         std::chrono::duration<double>(结束 - 开始).count()});
+  }
+
+  void 开工(任务池 &池, 并行状态 &状态, std::size_t 下标) {
+    池.提交([this, &池, &状态, 下标] {
+      auto 开始 = 时钟::now();
+      std::exception_ptr 错误;
+      try {
+        条目列表[下标].构造();
+      } catch (...) {
+        错误 = std::current_exception();
+      }
+      auto 结束 = 时钟::now();
+
+      std::vector<std::size_t> 就绪;
+      {
+        std::lock_guard 守卫(状态.锁);
+        if (错误) {
+          if (!状态.错误)
+            状态.错误 = 错误;
+        } else {
+          记录完成(下标, 开始, 结束);
+          if (!状态.错误)
+            for (std::size_t 后继 : 状态.图.后继[下标])
+              if (--状态.图.入度[后继] == 0)
+                就绪.push_back(后继);
+        }
+        状态.进行中 += 就绪.size();
+        // 持锁通知: 等待方醒来时本任务已不再访问 状态
+        if (--状态.进行中 == 0)
+          状态.全部结束.notify_all();
+      }
+      for (std::size_t 后继 : 就绪)
+        开工(池, 状态, 后继);
+    });
+  }
+};
@@ -1,6 +1,12 @@
 // 单例示例.h
 #pragma once
 
+#include "分片单例.h"
+#include "单例注册表.h"
+
+#include <atomic>
+#include <cstdint>
+
 class 游戏饿汉 {
 public:
   // 显式删除所有拷贝控制成员（拷贝构造、移动构造、拷贝赋值、移动赋值）
@@ -57,3 +63,69 @@ class 游戏管理器 : public 单例对象<游戏管理器> {
 private:
   游戏管理器() {} // 私有构造函数
 };
+
+// 使用 显式单例: 由 单例注册表 统一初始化和关闭, 每帧高频访问时没有守卫检查
+class 日志管理器 : public 显式单例<日志管理器> {
+  friend class 单例注册表;
+
+private:
+  日志管理器() {}
+};
+
+class 资源管理器 : public 显式单例<资源管理器> {
+  friend class 单例注册表;
+
+public:
+  using 依赖 = 单例依赖<日志管理器>;
+
+private:
+  资源管理器() {}
+};
+
+class 场景管理器 : public 显式单例<场景管理器> {
+  friend class 单例注册表;
+
+public:
+  using 依赖 = 单例依赖<资源管理器>; // 间接依赖 日志管理器
+  void 更新() { ++帧数; }
+  std::uint64_t 帧数 = 0;
+
+private:
+  场景管理器() {}
+};
+
+// 使用 分片单例: 每个线程累加自己的分片, 需要总数时再归并, 写入之间没有争用
+class 帧统计 : public 分片单例<帧统计> {
+  friend class 分片单例<帧统计>;
+
+public:
+  // 只有所属线程写入, relaxed 读改写即可, 不需要带锁前缀的原子加
+  void 记录帧(std::uint64_t 绘制调用) {
+    累加(帧数, 1);
+    累加(绘制调用数, 绘制调用);
+  }
+
+  struct 汇总 {
+    std::uint64_t 帧数 = 0;
+    std::uint64_t 绘制调用数 = 0;
+  };
+
+  static 汇总 全部() {
+    return 归并(汇总{}, [](汇总 和, const 帧统计 &分片) {
+      和.帧数 += 分片.帧数.load(std::memory_order_relaxed);
+      和.绘制调用数 += 分片.绘制调用数.load(std::memory_order_relaxed);
+      return 和;
+    });
+  }
+
+private:
+  帧统计() {}
+
+  static void 累加(std::atomic<std::uint64_t> &计数, std::uint64_t 增量) {
+    计数.store(计数.load(std::memory_order_relaxed) + 增量,
+               std::memory_order_relaxed);
+  }
+
+  std::atomic<std::uint64_t> 帧数{0};
+  std::atomic<std::uint64_t> 绘制调用数{0};
+};
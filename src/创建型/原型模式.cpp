@@ -1,34 +1,11 @@
+#include "原型示例.h"
+#include "图克隆.h"
 
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
 #include <print>
 
-class 球 {
-public:
-  virtual ~球() = default;
-  virtual std::unique_ptr<球> 克隆() const = 0;
-  // 需要访问派生类成员时
-  template <typename 子类型> 子类型 *作为() {
-    return dynamic_cast<子类型 *>(this);
-  }
-};
-
-// CRTP 模式
-template <class 子类> class 球接口 : public 球 {
-public:
-  std::unique_ptr<球>
-  克隆() const override { // 使用模板自动实现 克隆 的辅助工具类
-    const 子类 *子类实例 =
-        static_cast<const 子类 *>(this); // 静态转换 子类为父类
-    return std::make_unique<子类>(*子类实例);
-  }
-};
-
-class 爆炸球 : public 球接口<爆炸球> {};
-
-class 火焰球 : public 球接口<火焰球> {
-public:
-  int 温度{100}; // 如果有成员参数,也会一并复制到新对象中
-};
 int main(int argc, char *argv[]) {
   // 原型模式,将对象自己变成自己的工厂.
   // 避免 构造时的开销
@@ -36,17 +13,55 @@ int main(int argc, char *argv[]) {
   std::println("{}", 火球.温度);
 
   auto 火球2 = 火球.克隆(); // 返回的是基类指针
-  // 使用 dynamic_cast 基类指针转换为派生类指针
-  if (auto 火球2指针 = dynamic_cast<火焰球 *>(火球2.get())) {
+  // 使用 父类 提供的访问函数: 按类型编号区间检查, 不依赖 RTTI
+  if (auto 火球2指针 = 火球2->作为<火焰球>()) {
     std::println("{}", 火球2指针->温度); // 输出100
   }
-  // 使用 static_cast 静态转换 为派生类
+  // 确定类型时也可以直接 static_cast 静态转换 为派生类
   auto 火球2指针 = static_cast<火焰球 *>(火球2.get());
   std::println("{}", 火球2指针->温度); // 输出100
 
-  // 使用 父类 提供的访问函数
-  auto 火球2指针2 = 火球2->作为<火焰球>();
-  std::println("{}", 火球2指针2->温度); // 输出100
+  // 类型不符时返回 nullptr
+  auto 爆炸 = 爆炸球{}.克隆();
+  std::println("爆炸球 作为 火焰球: {}", 爆炸->作为<火焰球>() != nullptr); // false
+
+  // 多层层次: 蓝焰球 同时是 蓝焰球 和 火焰球
+  auto 蓝球 = 蓝焰球{}.克隆();
+  std::println("蓝焰球 作为 火焰球: {}", 蓝球->作为<火焰球>()->温度); // 输出300
+  std::println("火焰球 作为 蓝焰球: {}", 火球2->作为<蓝焰球>() != nullptr); // false
+
+  // 克隆到竞技场: 副本从调用方的内存资源分配
+  std::pmr::monotonic_buffer_resource 竞技场;
+  auto 竞技场火球 = 火球.克隆到(竞技场);
+  std::println("{}", 竞技场火球->作为<火焰球>()->温度); // 输出100
+
+  // 批量克隆: 一次填满一整块连续内存
+  alignas(火焰球) std::byte 存储[火焰球::批量字节(4)];
+  auto 火球批 = 火球.克隆批量(4, 存储);
+  std::println("批量克隆 {} 个, 末个温度 {}", 火球批.size(), 火球批.back().温度);
+  std::destroy(火球批.begin(), 火球批.end());
+
+  // 写时复制: 克隆共享参数, 第一次修改时才复制
+  共享火焰球 共享原型;
+  auto 共享克隆 = 共享原型.克隆();
+  auto 共享火球 = 共享克隆->作为<共享火焰球>();
+  std::println("修改前共享: {}", 共享火球->参数共享中()); // true
+  共享火球->设置温度(500);
+  std::println("修改后共享: {}, 原型 {}, 克隆 {}", 共享火球->参数共享中(),
+               共享原型.温度(), 共享火球->温度()); // false, 100, 500
+
+  // 图克隆: 被多处引用的子球只复制一次, 互相引用的环克隆后仍是环
+  火焰球 公用火球;
+  组合球 甲, 乙;
+  甲.子球 = {&公用火球, &乙};
+  乙.子球 = {&公用火球, &甲};
+  球图 副本图;
+  图克隆器 克隆器;
+  auto 甲副本 = 克隆器.克隆(甲, 副本图);
+  auto 乙副本 = 甲副本->子球[1]->作为<组合球>();
+  std::println("图克隆 {} 个节点, 共享保持: {}, 环保持: {}", 副本图.大小(),
+               甲副本->子球[0] == 乙副本->子球[0],
+               乙副本->子球[1] == 甲副本); // 3, true, true
 
   return 0;
 }
@@ -0,0 +1,330 @@
+// 原型模式基准.cpp
+// 用法: 原型模式基准 [基准名]   不带参数时运行全部基准
+// 请在 release 模式下构建: xmake f -m release && xmake run 原型模式基准
+#include "基准工具.h"
+#include "原型示例.h"
+#include "图克隆.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <print>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t 每轮克隆数 = 10'000;
+constexpr int 克隆轮数 = 200;
+
+// 地址跨度 / 有效字节: 1.0 表示完全连续, 越大越分散
+template <typename 指针列表类型>
+double 跨度比(const 指针列表类型 &指针列表, std::size_t 对象字节) {
+  std::uintptr_t 最小 = UINTPTR_MAX, 最大 = 0;
+  for (const auto &指针 : 指针列表) {
+    auto 地址 = reinterpret_cast<std::uintptr_t>(&*指针);
+    最小 = std::min(最小, 地址);
+    最大 = std::max(最大, 地址);
+  }
+  return static_cast<double>(最大 - 最小 + 对象字节) /
+         (指针列表.size() * 对象字节);
+}
+
+void 报告(std::string_view 名称, double 秒, double 跨度) {
+  std::println("  {:<22} {:>8.2f} 百万次/秒  地址跨度比 {:>6.2f}", 名称,
+               每轮克隆数 * 克隆轮数 / 秒 / 1e6, 跨度);
+}
+
+// 每轮从同一个原型克隆 每轮克隆数 个火焰球, 下一轮开始前全部销毁
+void 基准_克隆() {
+  std::println("[克隆] 每轮 {} 个火焰球, {} 轮", 每轮克隆数, 克隆轮数);
+  火焰球 原型;
+  const 球 &原型接口 = 原型;
+
+  std::vector<std::unique_ptr<球>> 堆副本(每轮克隆数);
+  double 堆秒 = 基准计时([&] {
+    for (int 轮 = 0; 轮 < 克隆轮数; ++轮)
+      for (auto &副本 : 堆副本)
+        副本 = 原型接口.克隆();
+  });
+  报告("克隆() make_unique", 堆秒, 跨度比(堆副本, sizeof(火焰球)));
+  堆副本.clear();
+
+  std::vector<竞技场球指针> 竞技场副本(每轮克隆数);
+  double 单调跨度 = 0;
+  double 单调秒 = 基准计时([&] {
+    std::pmr::monotonic_buffer_resource 竞技场(每轮克隆数 * sizeof(火焰球));
+    for (int 轮 = 0; 轮 < 克隆轮数; ++轮) {
+      for (auto &副本 : 竞技场副本)
+        副本 = 原型接口.克隆到(竞技场);
+      单调跨度 = 跨度比(竞技场副本, sizeof(火焰球));
+      for (auto &副本 : 竞技场副本)
+        副本.reset();
+      竞技场.release(); // 整轮一次性回收
+    }
+  });
+  报告("克隆到 单调竞技场", 单调秒, 单调跨度);
+
+  std::pmr::unsynchronized_pool_resource 池;
+  double 池秒 = 基准计时([&] {
+    for (int 轮 = 0; 轮 < 克隆轮数; ++轮)
+      for (auto &副本 : 竞技场副本)
+        副本 = 原型接口.克隆到(池);
+  });
+  报告("克隆到 内存池", 池秒, 跨度比(竞技场副本, sizeof(火焰球)));
+  竞技场副本.clear();
+
+  // new[] 返回的内存按 max_align_t 对齐, 足够放火焰球
+  auto 存储 =
+      std::make_unique_for_overwrite<std::byte[]>(火焰球::批量字节(每轮克隆数));
+  std::span<std::byte> 字节(存储.get(), 火焰球::批量字节(每轮克隆数));
+  std::span<火焰球> 批;
+  double 批量秒 = 基准计时([&] {
+    for (int 轮 = 0; 轮 < 克隆轮数; ++轮) {
+      批 = 原型.克隆批量(每轮克隆数, 字节);
+      防止优化(批.data());
+      if (轮 + 1 < 克隆轮数)
+        std::destroy(批.begin(), 批.end());
+    }
+  });
+  std::vector<火焰球 *> 批指针;
+  for (auto &对象 : 批)
+    批指针.push_back(&对象);
+  报告("克隆批量 连续块", 批量秒, 跨度比(批指针, sizeof(火焰球)));
+  std::destroy(批.begin(), 批.end());
+}
+
+// 单继承链: 层级球<N> 派生自 层级球<N-1>, 层级球<0> 派生自 球
+template <int 层> class 层级球 : public 球接口<层级球<层>, 层级球<层 - 1>> {};
+template <> class 层级球<0> : public 球接口<层级球<0>> {};
+
+constexpr int 最大层 = 8;
+constexpr std::size_t 检查对象数 = 4096;
+constexpr int 检查轮数 = 2000;
+
+template <int 层> std::unique_ptr<球> 创建层级球(int 目标层) {
+  if constexpr (层 < 最大层) {
+    if (目标层 > 层)
+      return 创建层级球<层 + 1>(目标层);
+  }
+  return std::make_unique<层级球<层>>();
+}
+
+// 对混合深度的对象逐个判断是否为 层级球<目标层>, 命中的比例约为 (最大层 - 目标层 + 1) / (最大层 + 1)
+template <int 目标层>
+void 比较类型检查(const std::vector<球 *> &对象列表) {
+  std::size_t 编号命中 = 0, 动态命中 = 0;
+  double 编号秒 = 基准计时([&] {
+    for (int 轮 = 0; 轮 < 检查轮数; ++轮)
+      for (球 *对象 : 对象列表) {
+        防止优化(对象);
+        编号命中 += 对象->作为<层级球<目标层>>() != nullptr;
+      }
+  });
+  double 动态秒 = 基准计时([&] {
+    for (int 轮 = 0; 轮 < 检查轮数; ++轮)
+      for (球 *对象 : 对象列表) {
+        防止优化(对象);
+        动态命中 += dynamic_cast<层级球<目标层> *>(对象) != nullptr;
+      }
+  });
+  if (编号命中 != 动态命中)
+    std::println("  结果不一致: {} != {}", 编号命中, 动态命中);
+  double 次数 = static_cast<double>(对象列表.size()) * 检查轮数;
+  std::println("  目标第 {} 层  作为 {:>6.2f} ns/次  dynamic_cast {:>6.2f} "
+               "ns/次  加速 {:>5.1f}x",
+               目标层, 编号秒 / 次数 * 1e9, 动态秒 / 次数 * 1e9,
+               动态秒 / 编号秒);
+}
+
+// 作为 (类型编号区间) 与 dynamic_cast 在深层单继承链上的对比
+void 基准_类型检查() {
+  std::println("[类型检查] {} 个对象, 深度 0..{} 均匀混合, {} 轮", 检查对象数,
+               最大层, 检查轮数);
+  std::vector<std::unique_ptr<球>> 对象;
+  std::vector<球 *> 对象列表;
+  std::uint32_t 种子 = 12345;
+  for (std::size_t i = 0; i < 检查对象数; ++i) {
+    种子 = 种子 * 1664525u + 1013904223u;
+    对象.push_back(创建层级球<0>(static_cast<int>((种子 >> 16) % (最大层 + 1))));
+    对象列表.push_back(对象.back().get());
+  }
+  比较类型检查<0>(对象列表);
+  比较类型检查<1>(对象列表);
+  比较类型检查<4>(对象列表);
+  比较类型检查<最大层>(对象列表);
+}
+
+// 对照组: 参数直接作为成员, 每次克隆都完整复制
+class 独立火焰球 : public 球接口<独立火焰球> {
+public:
+  火焰参数 参数;
+};
+
+constexpr std::size_t 写时复制克隆数 = 1'000'000;
+constexpr std::size_t 修改间隔 = 20; // 每 20 个修改 1 个, 即 5%
+
+struct 克隆结果 {
+  std::vector<std::unique_ptr<球>> 副本;
+  double 克隆秒 = 0;
+  double 修改秒 = 0;
+  std::size_t 内存增量 = 0;
+};
+
+template <typename 球类型, typename 修改函数类型>
+克隆结果 克隆并修改(修改函数类型 &&修改) {
+  克隆结果 结果;
+  球类型 原型;
+  std::size_t 之前 = 常驻内存字节();
+  结果.副本.resize(写时复制克隆数);
+  结果.克隆秒 = 基准计时([&] {
+    for (auto &副本 : 结果.副本)
+      副本 = 原型.克隆();
+  });
+  结果.修改秒 = 基准计时([&] {
+    for (std::size_t i = 0; i < 结果.副本.size(); i += 修改间隔)
+      修改(*结果.副本[i]->template 作为<球类型>(), static_cast<int>(i));
+  });
+  结果.内存增量 = 常驻内存字节() - 之前;
+  return 结果;
+}
+
+void 报告克隆(std::string_view 名称, const 克隆结果 &结果) {
+  std::println("  {:<10} 克隆 {:>7.1f} ms  修改 {:>6.2f} ms  内存增量 {:>7.1f} "
+               "MiB",
+               名称, 结果.克隆秒 * 1e3, 结果.修改秒 * 1e3,
+               结果.内存增量 / 1048576.0);
+}
+
+// 从同一原型克隆一百万个, 只修改其中 5%; 两组副本同时存活, 内存增量互不复用
+void 基准_写时复制() {
+  std::println("[写时复制] 克隆 {} 个, 修改 {}%, 参数 {} 字节", 写时复制克隆数,
+               100 / 修改间隔, sizeof(火焰参数));
+  auto 共享 = 克隆并修改<共享火焰球>(
+      [](共享火焰球 &对象, int 值) { 对象.设置温度(值); });
+  auto 独立 = 克隆并修改<独立火焰球>(
+      [](独立火焰球 &对象, int 值) { 对象.参数.温度 = 值; });
+  报告克隆("完整复制", 独立);
+  报告克隆("写时复制", 共享);
+}
+
+constexpr std::size_t 图节点数 = 100'000;
+constexpr std::size_t 每节点引用数 = 4;
+constexpr int 图克隆次数 = 20;
+
+// 节点 i 引用 i+1 (整体成环) 和 3 个随机节点, 平均每个节点被 4 处共享
+std::vector<std::unique_ptr<组合球>> 构造随机图() {
+  std::vector<std::unique_ptr<组合球>> 节点(图节点数);
+  for (auto &项 : 节点)
+    项 = std::make_unique<组合球>();
+  std::uint32_t 种子 = 2024;
+  for (std::size_t i = 0; i < 图节点数; ++i) {
+    auto &子球 = 节点[i]->子球;
+    子球.push_back(节点[(i + 1) % 图节点数].get());
+    while (子球.size() < 每节点引用数) {
+      种子 = 种子 * 1664525u + 1013904223u;
+      子球.push_back(节点[(种子 >> 8) % 图节点数].get());
+    }
+  }
+  return 节点;
+}
+
+// 每个副本的引用都应当指向原引用目标的副本
+bool 结构一致(const std::vector<std::unique_ptr<组合球>> &原图,
+              const 克隆映射 &映射表) {
+  for (const auto &原节点 : 原图) {
+    auto *副本 = static_cast<组合球 *>(映射表.查找(原节点.get()));
+    if (!副本 || 副本->子球.size() != 原节点->子球.size())
+      return false;
+    for (std::size_t k = 0; k < 副本->子球.size(); ++k)
+      if (副本->子球[k] != 映射表.查找(原节点->子球[k]))
+        return false;
+  }
+  return true;
+}
+
+void 基准_图克隆() {
+  std::println("[图克隆] {} 个节点, 每个节点 {} 个引用, 克隆 {} 次", 图节点数,
+               每节点引用数, 图克隆次数);
+  auto 原图 = 构造随机图();
+  const 组合球 &根 = *原图.front();
+  球图 副本图;
+
+  double 新建秒 = 基准计时([&] {
+    for (int 次 = 0; 次 < 图克隆次数; ++次) {
+      图克隆器 克隆器;
+      防止优化(克隆器.克隆(根, 副本图));
+    }
+  });
+
+  图克隆器 复用克隆器;
+  复用克隆器.预留(图节点数);
+  double 复用秒 = 基准计时([&] {
+    for (int 次 = 0; 次 < 图克隆次数; ++次)
+      防止优化(复用克隆器.克隆(根, 副本图));
+  });
+  bool 一致 = 副本图.大小() == 图节点数 && 结构一致(原图, 复用克隆器.映射表());
+  std::println("  每次新建克隆器 {:>7.2f} ms/次", 新建秒 / 图克隆次数 * 1e3);
+  std::println("  复用克隆器     {:>7.2f} ms/次  副本节点 {}  结构一致 {}",
+               复用秒 / 图克隆次数 * 1e3, 副本图.大小(), 一致);
+
+  // 单看映射表: 每次克隆都要对每个节点做 1 次插入和 每节点引用数 次查找
+  std::vector<const 球 *> 键(图节点数);
+  for (std::size_t i = 0; i < 图节点数; ++i)
+    键[i] = 原图[i].get();
+  std::size_t 命中 = 0;
+  double 开放寻址秒 = 基准计时([&] {
+    克隆映射 映射;
+    映射.预留(图节点数);
+    for (int 次 = 0; 次 < 图克隆次数; ++次) {
+      映射.清空();
+      for (const 球 *项 : 键)
+        映射.查找或插入(项) = const_cast<球 *>(项);
+      for (std::size_t k = 0; k < 每节点引用数; ++k)
+        for (const 球 *项 : 键)
+          命中 += 映射.查找(项) != nullptr;
+    }
+  });
+  double 标准秒 = 基准计时([&] {
+    std::unordered_map<const 球 *, 球 *> 映射;
+    映射.reserve(图节点数);
+    for (int 次 = 0; 次 < 图克隆次数; ++次) {
+      映射.clear();
+      for (const 球 *项 : 键)
+        映射.emplace(项, const_cast<球 *>(项));
+      for (std::size_t k = 0; k < 每节点引用数; ++k)
+        for (const 球 *项 : 键)
+          命中 += 映射.count(项);
+    }
+  });
+  防止优化(命中);
+  std::println("  映射表: 开放寻址 {:>6.2f} ms/次  std::unordered_map {:>6.2f} "
+               "ms/次",
+               开放寻址秒 / 图克隆次数 * 1e3, 标准秒 / 图克隆次数 * 1e3);
+}
+
+struct 基准项 {
+  std::string_view 名称;
+  void (*函数)();
+};
+
+constexpr 基准项 全部基准[] = {
+    {"克隆", 基准_克隆},
+    {"类型检查", 基准_类型检查},
+    {"写时复制", 基准_写时复制},
+    {"图克隆", 基准_图克隆},
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string_view 选择 = argc > 1 ? argv[1] : "";
+  for (const auto &项 : 全部基准) {
+    if (选择.empty() || 选择 == 项.名称)
+      项.函数();
+  }
+  return 0;
+}
@@ -0,0 +1,220 @@
+// 原型示例.h
+// 球原型层次; 示例程序与基准共用
+#pragma once
+
+#include "写时复制.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+class 球;
+class 图克隆器;
+
+// 球层次的类型节点: 按先序遍历编号, 每个类型的所有子孙编号落在 [首, 尾] 区间内
+// 判断"是否派生自"只需比较编号与区间, 不依赖 RTTI
+// 节点在编译期构造, 登记 (挂到父类下并重新编号) 发生在静态初始化期间
+class 球类型 {
+public:
+  constexpr explicit 球类型(球类型 *父类) : 父节点(父类) {}
+  球类型(const 球类型 &) = delete;
+  球类型 &operator=(const 球类型 &) = delete;
+
+  std::uint32_t 编号() const { return 首; }
+  const 球类型 *父类() const { return 父节点; }
+  bool 已登记() const { return 登记标志; }
+
+  // 自身或子孙类型; 无符号回绕使区间判断只需一次比较
+  bool 属于(const 球类型 &目标) const { return 首 - 目标.首 <= 目标.尾 - 目标.首; }
+
+  // 父类先于子类登记; 重复登记无副作用
+  // 只应在静态初始化或单线程阶段调用, 之后的判断只读不写
+  static void 登记(球类型 &节点) {
+    if (节点.登记标志)
+      return;
+    节点.登记标志 = true;
+    if (节点.父节点) {
+      登记(*节点.父节点);
+      节点.下个兄弟 = 节点.父节点->首个子类;
+      节点.父节点->首个子类 = &节点;
+    }
+    球类型 *根 = &节点;
+    while (根->父节点)
+      根 = 根->父节点;
+    std::uint32_t 下个编号 = 0;
+    根->编号子树(下个编号);
+  }
+
+private:
+  球类型 *父节点 = nullptr;
+  球类型 *首个子类 = nullptr;
+  球类型 *下个兄弟 = nullptr;
+  // 未登记的类型区间为 [最大值, 最大值], 不会匹配任何对象
+  std::uint32_t 首 = UINT32_MAX;
+  std::uint32_t 尾 = UINT32_MAX;
+  bool 登记标志 = false;
+
+  void 编号子树(std::uint32_t &下个编号) {
+    首 = 下个编号++;
+    for (球类型 *子 = 首个子类; 子; 子 = 子->下个兄弟)
+      子->编号子树(下个编号);
+    尾 = 下个编号 - 1;
+  }
+};
+
+// 从内存资源分配的球: 删除时先虚析构, 再按原大小与对齐归还给资源
+struct 资源删除器 {
+  std::pmr::memory_resource *资源 = nullptr;
+  std::size_t 字节 = 0;
+  std::size_t 对齐 = alignof(std::max_align_t);
+
+  void operator()(球 *对象) const;
+};
+using 竞技场球指针 = std::unique_ptr<球, 资源删除器>;
+
+class 球 {
+public:
+  virtual ~球() = default;
+  virtual std::unique_ptr<球> 克隆() const = 0;
+  // 在调用方提供的竞技场或池中构造副本, 不走全局堆
+  virtual 竞技场球指针 克隆到(std::pmr::memory_resource &竞技场) const = 0;
+  // 图克隆时对每个副本调用一次, 把仍指向原图的指针换成对应的副本
+  // 不持有其他球指针的类型无需重写 (见 图克隆.h)
+  virtual void 重定向引用(图克隆器 &) {}
+
+  // 需要访问派生类成员时; 类型不符返回 nullptr
+  template <typename 子类型> 子类型 *作为() {
+    return 是<子类型>() ? static_cast<子类型 *>(this) : nullptr;
+  }
+  template <typename 子类型> const 子类型 *作为() const {
+    return 是<子类型>() ? static_cast<const 子类型 *>(this) : nullptr;
+  }
+  template <typename 子类型> bool 是() const {
+    return 类型指针->属于(子类型::静态类型());
+  }
+
+  const 球类型 &类型() const { return *类型指针; }
+  static constexpr 球类型 &静态类型() { return 类型节点; }
+
+protected:
+  球() = default;
+  // 类型指针标识对象自身的动态类型, 复制时不随之复制, 由 球接口 重新设置
+  球(const 球 &) noexcept {}
+  球 &operator=(const 球 &) noexcept { return *this; }
+
+  const 球类型 *类型指针 = &类型节点;
+
+private:
+  static constinit inline 球类型 类型节点{nullptr};
+};
+
+inline void 资源删除器::operator()(球 *对象) const {
+  对象->~球();
+  资源->deallocate(对象, 字节, 对齐);
+}
+
+// CRTP 模式; 父类 为直接基类, 可以是另一个 球接口 派生类以构成多层层次
+template <class 子类, class 父类 = 球> class 球接口 : public 父类 {
+public:
+  球接口() { 设置类型(); }
+  // 源对象已经构造过, 类型必然已登记, 复制时不必再检查
+  球接口(const 球接口 &其他) : 父类(其他) { this->类型指针 = &类型节点; }
+  球接口 &operator=(const 球接口 &) = default;
+  // 父类没有默认构造函数时, 把参数转发给父类
+  template <typename 首参数类型, typename... 参数类型>
+    requires(!std::is_base_of_v<球接口, std::remove_cvref_t<首参数类型>> &&
+             std::is_constructible_v<父类, 首参数类型, 参数类型...>)
+  explicit 球接口(首参数类型 &&首参数, 参数类型 &&...参数)
+      : 父类(std::forward<首参数类型>(首参数), std::forward<参数类型>(参数)...) {
+    设置类型();
+  }
+
+  static constexpr 球类型 &静态类型() { return 类型节点; }
+
+  std::unique_ptr<球>
+  克隆() const override { // 使用模板自动实现 克隆 的辅助工具类
+    const 子类 *子类实例 =
+        static_cast<const 子类 *>(this); // 静态转换 子类为父类
+    return std::make_unique<子类>(*子类实例);
+  }
+
+  竞技场球指针 克隆到(std::pmr::memory_resource &竞技场) const override {
+    void *存储 = 竞技场.allocate(sizeof(子类), alignof(子类));
+    try {
+      球 *副本 = ::new (存储) 子类(*static_cast<const 子类 *>(this));
+      return 竞技场球指针(副本, {&竞技场, sizeof(子类), alignof(子类)});
+    } catch (...) {
+      竞技场.deallocate(存储, sizeof(子类), alignof(子类));
+      throw;
+    }
+  }
+
+  // 需要多少字节才能放下 数量 个副本
+  static constexpr std::size_t 批量字节(std::size_t 数量) {
+    return 数量 * sizeof(子类);
+  }
+
+  // 在连续内存块中构造 数量 个副本; 存储 须按 子类 对齐且不小于 批量字节(数量)
+  // 返回的对象由调用方负责析构 (std::destroy)
+  std::span<子类> 克隆批量(std::size_t 数量, std::span<std::byte> 存储) const {
+    if (存储.size() < 批量字节(数量))
+      throw std::length_error("克隆批量: 存储空间不足");
+    if (reinterpret_cast<std::uintptr_t>(存储.data()) % alignof(子类) != 0)
+      throw std::invalid_argument("克隆批量: 存储未按对象类型对齐");
+    auto *首个 = reinterpret_cast<子类 *>(存储.data());
+    std::uninitialized_fill_n(首个, 数量, *static_cast<const 子类 *>(this));
+    return {std::launder(首个), 数量};
+  }
+
+private:
+  // 节点编译期构造, 父节点地址是常量; 只有编号要在运行时计算
+  static constinit inline 球类型 类型节点{&父类::静态类型()};
+  // 在静态初始化期间完成登记, 之后多线程只读
+  static inline const bool 已自动登记 = (球类型::登记(类型节点), true);
+
+  void 设置类型() {
+    (void)已自动登记;
+    if (!类型节点.已登记()) [[unlikely]] // 静态初始化期间先于登记构造的对象
+      球类型::登记(类型节点);
+    this->类型指针 = &类型节点;
+  }
+};
+
+class 爆炸球 : public 球接口<爆炸球> {};
+
+class 火焰球 : public 球接口<火焰球> {
+public:
+  int 温度{100}; // 如果有成员参数,也会一并复制到新对象中
+};
+
+// 多层层次: 蓝焰球 也是一种 火焰球
+class 蓝焰球 : public 球接口<蓝焰球, 火焰球> {
+public:
+  蓝焰球() { 温度 = 300; }
+};
+
+// 一团火焰的完整外观参数; 大多数克隆出来后从不修改
+struct 火焰参数 {
+  int 温度 = 100;
+  std::array<float, 31> 粒子参数{};
+};
+
+// 写时复制原型: 克隆只复制句柄, 参数在第一次修改时才复制出独占的一份
+class 共享火焰球 : public 球接口<共享火焰球> {
+public:
+  int 温度() const { return 参数->温度; }
+  void 设置温度(int 新温度) { 参数.写().温度 = 新温度; }
+  const 火焰参数 &读参数() const { return 参数.读(); }
+  火焰参数 &改参数() { return 参数.写(); }
+  bool 参数共享中() const { return 参数.共享中(); }
+
+private:
+  写时复制<火焰参数> 参数;
+};
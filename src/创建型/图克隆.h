@@ -0,0 +1,182 @@
+// 图克隆.h
+// 克隆由 球 组成的对象图: 被多处引用的节点只复制一次, 环克隆后仍是环
+#pragma once
+
+#include "原型示例.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// 开放寻址 (线性探测) 的 原节点 -> 副本 映射
+// 清空只递增代数, 槽位和容量留给下一次克隆, 批量克隆时不必反复分配和重新散列
+class 克隆映射 {
+public:
+  // 保证插入 数量 个键之前不会扩容
+  void 预留(std::size_t 数量) {
+    if (数量 * 2 > 槽列表.size())
+      重建(std::bit_ceil(数量 * 2));
+  }
+
+  void 清空() {
+    已用 = 0;
+    if (++当前代数 == 0) { // 代数回绕时才真正清一次槽位
+      for (auto &项 : 槽列表)
+        项.代数 = 0;
+      当前代数 = 1;
+    }
+  }
+
+  球 *查找(const 球 *原节点) const {
+    if (槽列表.empty())
+      return nullptr;
+    for (std::size_t 位置 = 起点(原节点);; 位置 = (位置 + 1) & 掩码()) {
+      const 槽 &项 = 槽列表[位置];
+      if (项.代数 != 当前代数)
+        return nullptr;
+      if (项.原节点 == 原节点)
+        return 项.副本;
+    }
+  }
+
+  // 返回 原节点 对应副本的引用; 键不存在时插入并返回 nullptr 等待调用方填写
+  // 引用在下一次调用 查找或插入 之前有效
+  球 *&查找或插入(const 球 *原节点) {
+    if ((已用 + 1) * 2 > 槽列表.size())
+      重建(槽列表.empty() ? 64 : 槽列表.size() * 2);
+    for (std::size_t 位置 = 起点(原节点);; 位置 = (位置 + 1) & 掩码()) {
+      槽 &项 = 槽列表[位置];
+      if (项.代数 != 当前代数) {
+        项 = {原节点, nullptr, 当前代数};
+        ++已用;
+        return 项.副本;
+      }
+      if (项.原节点 == 原节点)
+        return 项.副本;
+    }
+  }
+
+  std::size_t 大小() const { return 已用; }
+  std::size_t 容量() const { return 槽列表.size(); }
+
+private:
+  struct 槽 {
+    const 球 *原节点 = nullptr;
+    球 *副本 = nullptr;
+    std::uint32_t 代数 = 0; // 不等于 当前代数 的槽视为空
+  };
+
+  std::vector<槽> 槽列表;
+  std::uint32_t 当前代数 = 1;
+  std::size_t 已用 = 0;
+  int 移位 = 64;
+
+  std::size_t 掩码() const { return 槽列表.size() - 1; }
+
+  // 斐波那契散列: 乘法把指针低位的对齐零位打散到高位
+  std::size_t 起点(const 球 *原节点) const {
+    auto 值 = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(原节点));
+    return static_cast<std::size_t>((值 * 0x9E3779B97F4A7C15ull) >> 移位);
+  }
+
+  void 重建(std::size_t 新容量) {
+    std::vector<槽> 旧槽列表(新容量);
+    旧槽列表.swap(槽列表);
+    移位 = 64 - std::countr_zero(新容量);
+    std::uint32_t 旧代数 = 当前代数;
+    当前代数 = 1;
+    已用 = 0;
+    for (const 槽 &项 : 旧槽列表)
+      if (项.代数 == 旧代数)
+        查找或插入(项.原节点) = 项.副本;
+  }
+};
+
+// 图克隆的结果: 所有副本分配在同一个竞技场里, 随 球图 一起销毁
+class 球图 {
+public:
+  球图() = default;
+  球图(const 球图 &) = delete;
+  球图 &operator=(const 球图 &) = delete;
+
+  球 *根() const { return 根节点; }
+  std::size_t 大小() const { return 节点.size(); }
+
+  void 清空() {
+    节点.clear();
+    竞技场.release();
+    根节点 = nullptr;
+  }
+
+private:
+  friend class 图克隆器;
+
+  std::pmr::monotonic_buffer_resource 竞技场; // 先于 节点 声明, 最后析构
+  std::vector<竞技场球指针> 节点;
+  球 *根节点 = nullptr;
+};
+
+// 可复用的图克隆器: 映射表和工作栈在多次克隆之间保留容量
+class 图克隆器 {
+public:
+  void 预留(std::size_t 节点数) {
+    已复制.预留(节点数);
+    待重定向.reserve(节点数);
+  }
+
+  // 把 根 可达的所有节点克隆进 目标 (目标原有内容先清空), 返回根的副本
+  // 用显式工作栈代替递归, 很深的链也不会耗尽调用栈
+  template <typename 类型> 类型 *克隆(const 类型 &根, 球图 &目标) {
+    目标.清空();
+    已复制.清空();
+    当前目标 = &目标;
+    球 *根副本 = 映射(static_cast<const 球 *>(&根));
+    while (!待重定向.empty()) {
+      球 *副本 = 待重定向.back();
+      待重定向.pop_back();
+      副本->重定向引用(*this);
+    }
+    当前目标 = nullptr;
+    目标.根节点 = 根副本;
+    return static_cast<类型 *>(根副本);
+  }
+
+  // 供 重定向引用 调用: 返回 原节点 的副本, 第一次遇到时先复制
+  // 副本在重定向之前就登记进映射, 所以环会指回已有的副本而不会无限展开
+  球 *映射(const 球 *原节点) {
+    if (!原节点)
+      return nullptr;
+    球 *&副本 = 已复制.查找或插入(原节点);
+    if (!副本) {
+      auto &节点列表 = 当前目标->节点;
+      节点列表.push_back(原节点->克隆到(当前目标->竞技场));
+      副本 = 节点列表.back().get();
+      待重定向.push_back(副本);
+    }
+    return 副本;
+  }
+
+  template <typename 类型> 类型 *映射(类型 *原节点) {
+    return static_cast<类型 *>(映射(static_cast<const 球 *>(原节点)));
+  }
+
+  const 克隆映射 &映射表() const { return 已复制; }
+
+private:
+  克隆映射 已复制;
+  std::vector<球 *> 待重定向;
+  球图 *当前目标 = nullptr;
+};
+
+// 持有其他球引用的组合节点; 引用可以共享, 也可以成环
+class 组合球 : public 球接口<组合球> {
+public:
+  std::vector<球 *> 子球;
+
+  void 重定向引用(图克隆器 &克隆器) override {
+    for (球 *&引用 : 子球)
+      引用 = 克隆器.映射(引用);
+  }
+};
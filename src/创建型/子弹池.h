@@ -0,0 +1,118 @@
+// 子弹池.h
+// 池化工厂: 子弹在预先分配的槽位上构造, 销毁时槽位回到空闲链表复用,
+// 射击不再为每枚子弹调用一次 new/delete
+#pragma once
+
+#include "工厂示例.h"
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+template <std::derived_from<子弹> 子弹类> class 子弹池;
+
+// 回收器: 作为 unique_ptr 的删除器, 析构子弹后把槽位还给所属的池
+template <std::derived_from<子弹> 子弹类> struct 子弹池回收器 {
+  子弹池<子弹类> *池 = nullptr;
+
+  void operator()(子弹类 *子弹实例) const noexcept {
+    子弹实例->子弹类::~子弹类(); // 类型已知, 不必走虚析构
+    池->还槽(子弹实例);
+  }
+};
+
+// 轻量回收句柄: 一个子弹指针加一个池指针, 离开作用域时自动归还槽位
+template <std::derived_from<子弹> 子弹类>
+using 子弹句柄 = std::unique_ptr<子弹类, 子弹池回收器<子弹类>>;
+
+// 按块 (slab) 分配固定大小的槽位, 空闲槽位串成单链表
+// 注意: 池必须比它发出的所有句柄活得更久
+template <std::derived_from<子弹> 子弹类> class 子弹池 {
+  union 槽位 {
+    槽位 *下一个;
+    alignas(子弹类) std::byte 存储[sizeof(子弹类)];
+  };
+
+  std::vector<std::unique_ptr<槽位[]>> 块列表;
+  槽位 *空闲链表 = nullptr;
+  std::size_t 每块槽数;
+  std::size_t 使用中 = 0;
+
+  void 扩容() {
+    auto 新块 = std::make_unique_for_overwrite<槽位[]>(每块槽数);
+    // 倒序入链, 使同一块内的槽位按地址顺序被取出
+    for (std::size_t i = 每块槽数; i-- > 0;) {
+      新块[i].下一个 = 空闲链表;
+      空闲链表 = &新块[i];
+    }
+    块列表.push_back(std::move(新块));
+  }
+
+public:
+  explicit 子弹池(std::size_t 每块槽数 = 256)
+      : 每块槽数(每块槽数 > 0 ? 每块槽数 : 1) {}
+  ~子弹池() { assert(使用中 == 0 && "子弹池销毁时仍有子弹未归还"); }
+
+  子弹池(const 子弹池 &) = delete;
+  子弹池 &operator=(const 子弹池 &) = delete;
+
+  // 取出一个未初始化的槽位
+  void *取槽() {
+    if (!空闲链表)
+      扩容();
+    槽位 *槽 = 空闲链表;
+    空闲链表 = 槽->下一个;
+    ++使用中;
+    return 槽->存储;
+  }
+
+  // 归还槽位, 调用前槽位上的对象必须已经析构
+  void 还槽(void *地址) noexcept {
+    auto *槽 = reinterpret_cast<槽位 *>(地址);
+    槽->下一个 = 空闲链表;
+    空闲链表 = 槽;
+    --使用中;
+  }
+
+  // 取一个槽位并调用 构造(void*) 在其上构造子弹; 构造抛出异常时归还槽位
+  template <typename 构造函数类型>
+  子弹句柄<子弹类> 就地创建(构造函数类型 &&构造) {
+    void *槽 = 取槽();
+    try {
+      子弹类 *子弹实例 = std::forward<构造函数类型>(构造)(槽);
+      return 子弹句柄<子弹类>(子弹实例, 子弹池回收器<子弹类>{this});
+    } catch (...) {
+      还槽(槽);
+      throw;
+    }
+  }
+
+  template <typename... 参数类型>
+    requires std::constructible_from<子弹类, 参数类型...>
+  子弹句柄<子弹类> 创建(参数类型 &&...参数) {
+    return 就地创建([&](void *槽) {
+      return ::new (槽) 子弹类(std::forward<参数类型>(参数)...);
+    });
+  }
+
+  std::size_t 使用中数量() const { return 使用中; }
+  std::size_t 容量() const { return 块列表.size() * 每块槽数; }
+};
+
+// 池化子弹枪: 沿用 子弹枪 的构造方式, 子弹放在调用方提供的 (可共享的) 子弹池里
+// 射出的子弹通常比枪活得久, 所以池不由枪创建: 调用方让池比所有句柄活得更久
+template <std::derived_from<子弹> 子弹类> class 池化子弹枪 {
+  子弹枪<子弹类> 枪实例;
+  std::shared_ptr<子弹池<子弹类>> 池;
+
+public:
+  池化子弹枪(子弹枪<子弹类> 枪实例, std::shared_ptr<子弹池<子弹类>> 共享池)
+      : 枪实例(std::move(枪实例)), 池(std::move(共享池)) {}
+
+  子弹句柄<子弹类> 射击() {
+    return 池->就地创建([this](void *槽) { return 枪实例.就地射击(槽); });
+  }
+
+  const std::shared_ptr<子弹池<子弹类>> &获取池() const { return 池; }
+};
@@ -1,84 +1,18 @@
-#include <functional>
+#include "子弹池.h"
+#include "工厂示例.h"
+#include "开火调度器.h"
+#include "武器注册表.h"
+#include "线程子弹池.h"
+#include "计数随机数.h"
+#include "预热子弹枪.h"
+
+#include <chrono>
+#include <exception>
 #include <memory>
 #include <print>
+#include <thread>
 #include <utility>
 
-struct 子弹 {
-  virtual void 激发() = 0;
-  virtual ~子弹() = default;
-};
-
-struct 实体子弹 : 子弹 {
-  void 激发() override { std::println("物理伤害"); }
-};
-
-struct 能量子弹 : 子弹 {
-  void 激发() override { std::println("能量伤害"); }
-};
-
-struct ak47子弹 : 子弹 {
-  int 攻击力 = 0;
-  ak47子弹(int 攻击力) : 攻击力(攻击力) {}
-  void 激发() override { std::println("造成{}点物理伤害", 攻击力); }
-};
-
-class 枪 {
-public:
-  // 智能指针 自动管理内存
-  virtual std::unique_ptr<子弹> 射击() = 0;
-  virtual ~枪() = default;
-};
-
-// 使用模板批量制造子弹工厂
-// 使用概念库 <concepts>约束为从子弹派生的类型  std::derived_from<子弹>子弹类
-template <std::derived_from<子弹> 子弹类> class 子弹枪 : public 枪 {
-
-  // 使用 move_only_function 更高效
-  using 创建函数类型 = std::move_only_function<std::unique_ptr<子弹类>()>;
-  创建函数类型 创建函数;
-
-public:
-  // 默认构造 (无参)
-  子弹枪() : 创建函数([] { return std::make_unique<子弹类>(); }) {}
-
-  // 带参数构造 - 使用完美转发
-  template <typename... 参数类型>
-    requires std::constructible_from<子弹类, 参数类型...>
-  explicit 子弹枪(参数类型 &&...参数) {
-    using 存储类型 = std::tuple<std::decay_t<参数类型>...>;
-    auto 参数存储 = std::make_shared<存储类型>(std::forward<参数类型>(参数)...);
-
-    创建函数 = [参数存储] {
-      return std::apply(
-          [](auto &&...args) {
-            return std::make_unique<子弹类>(
-                std::forward<decltype(args)>(args)...);
-          },
-          *参数存储);
-    };
-  }
-  // 初始化列表专用构造函数
-  template <typename T>
-    requires requires(std::initializer_list<T> il) {
-      { std::make_unique<子弹类>(il) } -> std::same_as<std::unique_ptr<子弹类>>;
-    }
-  explicit 子弹枪(std::initializer_list<T> il)
-      : 创建函数([il]() mutable { return std::make_unique<子弹类>(il); }) {}
-
-  // 支持工厂函数作为参数
-  explicit 子弹枪(创建函数类型 工厂函数) : 创建函数(std::move(工厂函数)) {}
-
-  // 移动操作
-  子弹枪(子弹枪 &&) = default;
-  子弹枪 &operator=(子弹枪 &&) = default;
-
-  // 禁止复制
-  子弹枪(const 子弹枪 &) = delete;
-  子弹枪 &operator=(const 子弹枪 &) = delete;
-
-  std::unique_ptr<子弹> 射击() override { return 创建函数(); }
-};
-
 void 玩家(枪 &枪实例) {
   for (int i = 0; i < 2; i++) {
     std::unique_ptr<子弹> 射出子弹 = 枪实例.射击();
@@ -99,36 +33,19 @@ int main() {
   玩家(ak47);
 
   // 3. 带复杂参数
-  struct 元素子弹 : 子弹 {
-    std::string 元素;
-    int 伤害;
-    元素子弹(std::string 元素, int 伤害) : 元素(std::move(元素)), 伤害(伤害) {}
-    void 激发() override { std::println("{}元素伤害: {}点", 元素, 伤害); }
-  };
-
   auto 火焰枪 = 子弹枪<元素子弹>("火焰", 150);
   auto b3 = 火焰枪.射击();
   b3->激发(); // 火焰元素伤害: 150点
 
   // 4. 使用初始化列表
-  struct 霰弹 : 子弹 {
-    std::vector<int> 弹丸;
-    霰弹(std::initializer_list<int> 弹丸) : 弹丸(弹丸) {}
-    void 激发() override {
-      std::print("霰弹发射: ");
-      for (int d : 弹丸)
-        std::print("{} ", d);
-      std::println("");
-    }
-  };
-
   auto 霰弹枪 = 子弹枪<霰弹>({10, 20, 30, 40});
   auto b4 = 霰弹枪.射击();
   b4->激发(); // 霰弹发射: 10 20 30 40
 
   // 5. 使用自定义工厂函数
-  auto 随机伤害工厂 = [] {
-    int 伤害 = 80 + (std::rand() % 40); // 80-119
+  // 每把枪持有自己的计数随机数, 相同种子总是得到相同的伤害序列
+  auto 随机伤害工厂 = [随机数 = 计数随机数(47)]() mutable {
+    int 伤害 = 随机数.范围(80, 120); // 80-119
     return std::make_unique<ak47子弹>(伤害);
   };
 
@@ -144,5 +61,84 @@ int main() {
   b6->激发(); // 冰冻元素伤害: 75点
 
   玩家(冰冻枪);
+
+  // 7. 池化工厂: 子弹在池的槽位上构造, 句柄析构时槽位回收复用
+  // 池先于枪和子弹声明, 最后销毁
+  auto ak47池 = std::make_shared<子弹池<ak47子弹>>();
+  auto 池化ak47 = 池化子弹枪(子弹枪<ak47子弹>(100), ak47池);
+  {
+    auto b7 = 池化ak47.射击();
+    b7->激发(); // 造成100点物理伤害
+  } // b7 的槽位回到池中
+  auto b8 = 池化ak47.射击(); // 复用同一个槽位
+  b8->激发();
+  std::println("池容量: {}, 使用中: {}", 池化ak47.获取池()->容量(),
+               池化ak47.获取池()->使用中数量());
+
+  // 多把枪可以共享同一个池
+  auto 共享池 = std::make_shared<子弹池<元素子弹>>();
+  auto 火焰池枪 = 池化子弹枪(子弹枪<元素子弹>("火焰", 150), 共享池);
+  auto 冰冻池枪 = 池化子弹枪(子弹枪<元素子弹>("冰冻", 75), 共享池);
+  火焰池枪.射击()->激发();
+  冰冻池枪.射击()->激发();
+
+  // 8. 批量射击: 同类型子弹连续构造, 整批激发只做一次分派
+  auto 弹幕 = 霰弹枪.射击批量(3);
+  激发批量(弹幕.视图());
+
+  枪 &齐射枪 = ak47;
+  齐射枪.齐射(3); // 一次虚调用完成整轮齐射
+
+  // 9. 值语义子弹: 小子弹存放在返回值内部, 大子弹才分配到堆上
+  枪 &值枪 = ak47;
+  子弹值 b9 = 值枪.射击值();
+  b9->激发();
+  子弹值 b10 = 火焰枪.射击值();
+  b10->激发();
+  std::println("ak47子弹内联: {}, 元素子弹内联: {}", b9.内联存储(),
+               b10.内联存储()); // true, false
+
+  // 10. 数据驱动: 从定义文件加载武器, 运行时按名称生成
+  武器注册表 注册表;
+  try {
+    std::println("加载了 {} 种武器", 注册表.加载定义文件("武器定义.txt"));
+    auto 雷电枪 = 注册表.生成("雷电枪");
+    雷电枪->射击()->激发(); // 雷电元素伤害: 120点
+    if (auto 编号 = 注册表.查找("霰弹枪"))
+      注册表.生成(*编号)->齐射(2);
+  } catch (const std::exception &错误) {
+    std::println("武器定义加载失败: {}", 错误.what());
+  }
+
+  // 11. 多线程: 每个线程从自己的竞技场分配, 跨线程销毁经归还栈回收
+  auto 线程工厂 = std::make_shared<线程子弹工厂<ak47子弹>>();
+  线程子弹句柄<ak47子弹> 工作线程子弹;
+  std::thread([&] {
+    线程池化子弹枪 工作枪(子弹枪<ak47子弹>(200), 线程工厂);
+    工作线程子弹 = 工作枪.射击();
+  }).join();
+  工作线程子弹->激发(); // 造成200点物理伤害
+  工作线程子弹.reset(); // 在主线程销毁, 槽位送回工作线程的竞技场
+  std::println("竞技场数量: {}", 线程工厂->竞技场数量());
+
+  // 12. 预热模式: 后台线程提前构造子弹, 射击时直接取用
+  子弹预热器 预热器;
+  预热子弹枪<元素子弹> 预热火焰枪(预热器, 子弹枪<元素子弹>("火焰", 150), 8);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10)); // 模拟帧间空闲
+  玩家(预热火焰枪);
+  std::println("预热队列深度: {}/{}, 未命中率: {:.2f}", 预热火焰枪.队列深度(),
+               预热火焰枪.队列容量(), 预热火焰枪.未命中率());
+
+  // 13. 开火调度: 按射速登记, 每刻只处理到期的枪
+  开火调度器 调度器;
+  调度器.登记(ak47, 2);                 // 每 2 刻开火一次
+  auto 霰弹句柄 = 调度器.登记(霰弹枪, 3); // 每 3 刻开火一次
+  for (int 刻 = 0; 刻 < 4; ++刻)
+    调度器.推进();
+  调度器.取消(霰弹句柄);
+  调度器.推进(); // 只剩 ak47 到期
+  std::println("已推进 {} 刻, 到期 {} 次, 调度耗时 {:.1f} 微秒",
+               调度器.获取统计().刻数, 调度器.获取统计().到期总数,
+               调度器.获取统计().调度秒数 * 1e6);
   return 0;
 }
@@ -0,0 +1,427 @@
+// 工厂模式基准.cpp
+// 用法: 工厂模式基准 [基准名]   不带参数时运行全部基准
+// 请在 release 模式下构建: xmake f -m release && xmake run 工厂模式基准
+#include "子弹池.h"
+#include "工厂示例.h"
+#include "开火调度器.h"
+#include "基准工具.h"
+#include "武器注册表.h"
+#include "线程子弹池.h"
+#include "计数随机数.h"
+#include "预热子弹枪.h"
+
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <memory>
+#include <print>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t 射击次数 = 10'000'000;
+// 同时在飞的子弹数: 模拟上千把枪每帧开火, 子弹存活若干帧后销毁
+constexpr std::size_t 在飞子弹数 = 100'000;
+
+void 报告(std::string_view 名称, double 秒, std::size_t 内存增量) {
+  std::println("  {:<16} {:>8.2f} 百万发/秒  常驻内存增量 {:>8.2f} MiB", 名称,
+               射击次数 / 秒 / 1e6, 内存增量 / (1024.0 * 1024.0));
+}
+
+// 环形缓冲保存在飞的子弹, 新子弹替换最早的一枚, 迫使旧子弹被释放
+template <typename 射击函数类型>
+void 连续射击(std::string_view 名称, 射击函数类型 &&射击) {
+  using 子弹指针 = decltype(射击());
+  auto 内存前 = 常驻内存字节();
+  std::vector<子弹指针> 在飞(在飞子弹数);
+  double 秒 = 基准计时([&] {
+    for (std::size_t i = 0; i < 射击次数; ++i) {
+      在飞[i % 在飞子弹数] = 射击();
+      防止优化(在飞[i % 在飞子弹数]);
+    }
+  });
+  报告(名称, 秒, 常驻内存字节() - 内存前);
+}
+
+// 常驻内存受分配器缓存影响, 对比内存时请分别单独运行这两项
+void 基准_堆射击() {
+  std::println("[射击/unique_ptr] {} 发, {} 枚在飞", 射击次数, 在飞子弹数);
+  auto ak47枪 = 子弹枪<ak47子弹>(100);
+  连续射击("ak47子弹", [&] { return ak47枪.射击(); });
+  auto 火焰枪 = 子弹枪<元素子弹>("火焰", 150);
+  连续射击("元素子弹", [&] { return 火焰枪.射击(); });
+}
+
+void 基准_池化射击() {
+  std::println("[射击/子弹池] {} 发, {} 枚在飞", 射击次数, 在飞子弹数);
+  auto ak47池 = std::make_shared<子弹池<ak47子弹>>();
+  auto ak47枪 = 池化子弹枪(子弹枪<ak47子弹>(100), ak47池);
+  连续射击("ak47子弹", [&] { return ak47枪.射击(); });
+  auto 元素池 = std::make_shared<子弹池<元素子弹>>();
+  auto 火焰枪 = 池化子弹枪(子弹枪<元素子弹>("火焰", 150), 元素池);
+  连续射击("元素子弹", [&] { return 火焰枪.射击(); });
+}
+
+// 元素子弹超出内联容量, 会退回到堆上
+void 基准_值射击() {
+  std::println("[射击/子弹值] {} 发, {} 枚在飞", 射击次数, 在飞子弹数);
+  auto ak47枪 = 子弹枪<ak47子弹>(100);
+  连续射击("ak47子弹", [&] { return ak47枪.射击值(); });
+  auto 霰弹枪 = 子弹枪<霰弹>({10, 20, 30, 40});
+  连续射击("霰弹", [&] { return 霰弹枪.射击值(); });
+  auto 火焰枪 = 子弹枪<元素子弹>("火焰", 150);
+  连续射击("元素子弹", [&] { return 火焰枪.射击值(); });
+}
+
+// 激发时只累加伤害, 不打印, 用来衡量分派本身的开销
+long long 累计伤害 = 0;
+struct 基准子弹 : 子弹 {
+  int 伤害;
+  explicit 基准子弹(int 伤害) : 伤害(伤害) {}
+  void 激发() override { 累计伤害 += 伤害; }
+};
+
+constexpr std::size_t 每轮弹丸数 = 64;
+constexpr std::size_t 齐射轮数 = 射击次数 / 每轮弹丸数;
+
+void 基准_齐射() {
+  std::println("[齐射] {} 轮 x {} 发", 齐射轮数, 每轮弹丸数);
+  auto 弹幕枪 = 子弹枪<基准子弹>(7);
+  枪 &枪接口 = 弹幕枪;
+
+  // 逐发: 每发一次 射击/激发 虚调用和一次堆分配
+  累计伤害 = 0;
+  double 逐发秒 = 基准计时([&] {
+    for (std::size_t 轮 = 0; 轮 < 齐射轮数; ++轮)
+      for (std::size_t i = 0; i < 每轮弹丸数; ++i)
+        枪接口.射击()->激发();
+  });
+  防止优化(累计伤害);
+
+  // 批量: 每轮一次 齐射 虚调用, 子弹按具体类型连续构造、静态分派激发
+  累计伤害 = 0;
+  double 批量秒 = 基准计时([&] {
+    for (std::size_t 轮 = 0; 轮 < 齐射轮数; ++轮)
+      枪接口.齐射(每轮弹丸数);
+  });
+  防止优化(累计伤害);
+
+  std::println("  逐发 {:>8.2f} 百万发/秒", 射击次数 / 逐发秒 / 1e6);
+  std::println("  批量 {:>8.2f} 百万发/秒", 射击次数 / 批量秒 / 1e6);
+}
+
+constexpr std::size_t 武器种数 = 500;
+constexpr std::size_t 查找次数 = 10'000'000;
+
+void 基准_武器查找() {
+  std::println("[武器查找] {} 种武器, {} 次按名查找", 武器种数, 查找次数);
+  std::ostringstream 定义;
+  std::vector<std::string> 名称列表;
+  for (std::size_t i = 0; i < 武器种数; ++i) {
+    名称列表.push_back(std::format("元素武器_{}", i));
+    定义 << 名称列表.back() << " 元素子弹 火焰 " << i << '\n';
+  }
+
+  武器注册表 注册表;
+  std::istringstream 输入(定义.str());
+  double 加载秒 = 基准计时([&] { 注册表.加载定义(输入); });
+
+  std::unordered_map<std::string, std::size_t> 映射;
+  for (std::size_t i = 0; i < 名称列表.size(); ++i)
+    映射.emplace(名称列表[i], i);
+
+  // 从 string_view 查找: 生成武器时名称通常来自配置或网络消息
+  std::vector<std::string_view> 查询;
+  for (std::size_t i = 0; i < 查找次数; ++i)
+    查询.push_back(名称列表[(i * 7919) % 武器种数]);
+
+  std::size_t 命中 = 0;
+  double 映射秒 = 基准计时([&] {
+    for (auto 名称 : 查询)
+      命中 += 映射.find(std::string(名称))->second;
+  });
+  防止优化(命中);
+  double 完美哈希秒 = 基准计时([&] {
+    for (auto 名称 : 查询)
+      命中 += *注册表.查找(名称);
+  });
+  防止优化(命中);
+
+  std::println("  加载定义      {:>8.3f} 毫秒", 加载秒 * 1e3);
+  std::println("  unordered_map {:>8.2f} 纳秒/次", 映射秒 / 查找次数 * 1e9);
+  std::println("  完美哈希      {:>8.2f} 纳秒/次", 完美哈希秒 / 查找次数 * 1e9);
+}
+
+// 每轮: 各线程先射出一批子弹, 同步后销毁下一个线程的那一批,
+// 因此每枚子弹都在另一个线程上归还, 覆盖跨线程回收路径
+constexpr std::size_t 每轮每线程发数 = 10'000;
+constexpr std::size_t 多线程轮数 = 200;
+
+template <typename 射击函数工厂类型>
+double 多线程射击(std::size_t 线程数, 射击函数工厂类型 &&创建射击函数) {
+  using 子弹指针 = decltype(创建射击函数()());
+  std::vector<std::vector<子弹指针>> 批次(线程数);
+  std::barrier 同步点(static_cast<std::ptrdiff_t>(线程数));
+  std::vector<std::thread> 线程列表;
+
+  auto 开始 = 基准时钟::now();
+  for (std::size_t 线程号 = 0; 线程号 < 线程数; ++线程号) {
+    线程列表.emplace_back([&, 线程号] {
+      auto 射击 = 创建射击函数();
+      auto &自己的 = 批次[线程号];
+      auto &下一个 = 批次[(线程号 + 1) % 线程数];
+      自己的.reserve(每轮每线程发数);
+      for (std::size_t 轮 = 0; 轮 < 多线程轮数; ++轮) {
+        for (std::size_t i = 0; i < 每轮每线程发数; ++i)
+          自己的.push_back(射击());
+        同步点.arrive_and_wait();
+        下一个.clear();
+        同步点.arrive_and_wait();
+      }
+    });
+  }
+  for (auto &线程 : 线程列表)
+    线程.join();
+  std::chrono::duration<double> 用时 = 基准时钟::now() - 开始;
+  return 用时.count();
+}
+
+void 基准_多线程射击() {
+  const std::size_t 核数 = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::size_t> 线程数列表;
+  for (std::size_t n = 1; n < 核数; n *= 2)
+    线程数列表.push_back(n);
+  线程数列表.push_back(核数);
+
+  std::println("[多线程射击] 每线程 {} 轮 x {} 发, 全部跨线程销毁", 多线程轮数,
+               每轮每线程发数);
+  std::println("  {:>4} {:>22} {:>22}", "线程", "unique_ptr 百万发/秒/线程",
+               "线程竞技场 百万发/秒/线程");
+  for (std::size_t 线程数 : 线程数列表) {
+    const double 每线程发数 = 多线程轮数 * 每轮每线程发数;
+    double 堆秒 = 多线程射击(线程数, [] {
+      return [枪实例 = 子弹枪<ak47子弹>(100)]() mutable {
+        return 枪实例.射击();
+      };
+    });
+    auto 工厂 = std::make_shared<线程子弹工厂<ak47子弹>>(4096);
+    double 竞技场秒 = 多线程射击(线程数, [&] {
+      return [枪实例 = 线程池化子弹枪(子弹枪<ak47子弹>(100), 工厂)]() mutable {
+        return 枪实例.射击();
+      };
+    });
+    std::println("  {:>4} {:>22.2f} {:>22.2f}", 线程数,
+                 每线程发数 / 堆秒 / 1e6, 每线程发数 / 竞技场秒 / 1e6);
+  }
+}
+
+constexpr std::size_t 掷骰次数 = 50'000'000;
+
+void 基准_伤害随机数() {
+  std::println("[伤害随机数] {} 次伤害掷骰 (80-119)", 掷骰次数);
+  std::vector<int> 伤害(掷骰次数);
+
+  std::srand(47);
+  double rand秒 = 基准计时([&] {
+    for (auto &值 : 伤害)
+      值 = 80 + std::rand() % 40;
+  });
+  防止优化(伤害.data());
+
+  计数随机数 逐个(47);
+  double 逐个秒 = 基准计时([&] {
+    for (auto &值 : 伤害)
+      值 = 逐个.范围(80, 120);
+  });
+  防止优化(伤害.data());
+
+  计数随机数 批量(47);
+  double 批量秒 = 基准计时([&] { 批量.批量范围(伤害, 80, 120); });
+  防止优化(伤害.data());
+
+  // 把同一条随机流切成若干段交给多个线程, 结果必须与单线程完全一致
+  const std::size_t 线程数 = std::max(2u, std::thread::hardware_concurrency());
+  std::vector<int> 分段(掷骰次数);
+  double 多线程秒 = 基准计时([&] {
+    std::vector<std::thread> 线程列表;
+    const std::size_t 每段 = (掷骰次数 + 线程数 - 1) / 线程数;
+    for (std::size_t 段 = 0; 段 < 线程数; ++段) {
+      线程列表.emplace_back([&, 段] {
+        std::size_t 起点 = std::min(段 * 每段, 掷骰次数);
+        std::size_t 长度 = std::min(每段, 掷骰次数 - 起点);
+        计数随机数 随机数(47, 起点);
+        随机数.批量范围(std::span(分段).subspan(起点, 长度), 80, 120);
+      });
+    }
+    for (auto &线程 : 线程列表)
+      线程.join();
+  });
+
+  std::println("  std::rand     {:>8.2f} 百万次/秒", 掷骰次数 / rand秒 / 1e6);
+  std::println("  计数随机数    {:>8.2f} 百万次/秒", 掷骰次数 / 逐个秒 / 1e6);
+  std::println("  批量范围      {:>8.2f} 百万次/秒", 掷骰次数 / 批量秒 / 1e6);
+  std::println("  {} 线程分段   {:>8.2f} 百万次/秒, 与单线程结果{}", 线程数,
+               掷骰次数 / 多线程秒 / 1e6, 分段 == 伤害 ? "一致" : "不一致");
+}
+
+// 构造开销较大的子弹: 构造时预先计算一段弹道表
+struct 昂贵子弹 : 子弹 {
+  std::vector<float> 弹道;
+  explicit 昂贵子弹(int 点数) : 弹道(点数) {
+    for (int i = 0; i < 点数; ++i)
+      弹道[i] = std::sin(i * 0.01f) * static_cast<float>(i);
+  }
+  void 激发() override { 累计伤害 += static_cast<long long>(弹道.back()); }
+};
+
+constexpr int 预热帧数 = 2'000;
+constexpr int 每帧发数 = 16;
+constexpr auto 帧间空闲 = std::chrono::microseconds(300);
+
+// 返回 {平均每帧开火耗时, 最大每帧开火耗时}, 单位微秒
+std::pair<double, double> 逐帧开火(枪 &枪实例) {
+  double 总计 = 0, 最大 = 0;
+  std::vector<std::unique_ptr<子弹>> 本帧;
+  for (int 帧 = 0; 帧 < 预热帧数; ++帧) {
+    double 秒 = 基准计时([&] {
+      for (int i = 0; i < 每帧发数; ++i)
+        本帧.push_back(枪实例.射击());
+    });
+    总计 += 秒;
+    最大 = std::max(最大, 秒);
+    本帧.clear();
+    std::this_thread::sleep_for(帧间空闲); // 帧内其余工作, 预热线程在此期间补充
+  }
+  return {总计 / 预热帧数 * 1e6, 最大 * 1e6};
+}
+
+void 基准_预热射击() {
+  std::println("[预热射击] {} 帧, 每帧 {} 发昂贵子弹", 预热帧数, 每帧发数);
+  auto 同步枪 = 子弹枪<昂贵子弹>(2048);
+  auto [同步平均, 同步最大] = 逐帧开火(同步枪);
+
+  子弹预热器 预热器;
+  预热子弹枪<昂贵子弹> 预热枪(预热器, 子弹枪<昂贵子弹>(2048), 64);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  auto [预热平均, 预热最大] = 逐帧开火(预热枪);
+
+  std::println("  同步构造  平均 {:>8.2f} 微秒/帧  最大 {:>8.2f}", 同步平均,
+               同步最大);
+  std::println("  预热队列  平均 {:>8.2f} 微秒/帧  最大 {:>8.2f}  未命中率 "
+               "{:.2f}%  当前深度 {}/{}",
+               预热平均, 预热最大, 预热枪.未命中率() * 100, 预热枪.队列深度(),
+               预热枪.队列容量());
+}
+
+constexpr std::size_t 调度枪数 = 50'000;
+constexpr int 调度刻数 = 6'000;
+constexpr double 每秒刻数 = 60;
+
+// 对比逐刻轮询所有枪与时间轮只处理到期的枪; 回调只计数, 测的是纯调度开销
+// 射速以 0.1 发/秒为单位, 在 [最低射速, 最高射速] 内随机
+void 调度对比(std::string_view 场景, int 最低射速, int 最高射速) {
+  std::println("  -- {}: 射速 {:.1f}-{:.1f} 发/秒", 场景, 最低射速 / 10.0,
+               最高射速 / 10.0);
+  std::vector<子弹枪<基准子弹>> 枪列表;
+  枪列表.reserve(调度枪数);
+  std::vector<std::uint64_t> 间隔(调度枪数);
+  计数随机数 随机数(47);
+  for (std::size_t i = 0; i < 调度枪数; ++i) {
+    枪列表.emplace_back(1);
+    double 射速 = 随机数.范围(最低射速, 最高射速 + 1) / 10.0;
+    间隔[i] = static_cast<std::uint64_t>(std::ceil(每秒刻数 / 射速));
+  }
+
+  std::vector<std::uint64_t> 下次开火(间隔);
+  std::vector<枪 *> 到期;
+  std::uint64_t 轮询到期 = 0;
+  double 轮询秒 = 基准计时([&] {
+    for (int 刻 = 1; 刻 <= 调度刻数; ++刻) {
+      到期.clear();
+      for (std::size_t i = 0; i < 调度枪数; ++i) {
+        if (下次开火[i] == static_cast<std::uint64_t>(刻)) {
+          到期.push_back(&枪列表[i]);
+          下次开火[i] += 间隔[i];
+        }
+      }
+      轮询到期 += 到期.size();
+      防止优化(到期.data());
+    }
+  });
+
+  开火调度器 调度器;
+  for (std::size_t i = 0; i < 调度枪数; ++i)
+    调度器.登记(枪列表[i], 间隔[i]);
+  std::uint64_t 时间轮到期 = 0;
+  double 最大刻秒 = 0;
+  for (int 刻 = 0; 刻 < 调度刻数; ++刻) {
+    double 前 = 调度器.获取统计().调度秒数;
+    调度器.推进([&](std::span<枪 *const> 批次, std::span<const std::uint32_t>) {
+      时间轮到期 += 批次.size();
+    });
+    最大刻秒 = std::max(最大刻秒, 调度器.获取统计().调度秒数 - 前);
+  }
+  const auto &统计 = 调度器.获取统计();
+  std::println("  逐刻轮询   平均 {:>8.2f} 微秒/刻  到期 {}",
+               轮询秒 / 调度刻数 * 1e6, 轮询到期);
+  std::println("  分层时间轮 平均 {:>8.2f} 微秒/刻  最大 {:>8.2f}  到期 {}  "
+               "级联 {}",
+               统计.调度秒数 / 调度刻数 * 1e6, 最大刻秒 * 1e6, 时间轮到期,
+               统计.级联移动数);
+
+  // 实际开火: 到期的枪逐把齐射
+  调度器.重置统计();
+  double 开火秒 = 基准计时([&] {
+    for (int 刻 = 0; 刻 < 调度刻数; ++刻)
+      调度器.推进();
+  });
+  防止优化(累计伤害);
+  std::println("  含开火     平均 {:>8.2f} 微秒/刻  其中调度 {:>8.2f}",
+               开火秒 / 调度刻数 * 1e6,
+               调度器.获取统计().调度秒数 / 调度刻数 * 1e6);
+}
+
+void 基准_开火调度() {
+  std::println("[开火调度] {} 把枪, 每秒 {} 刻, 共 {} 刻", 调度枪数, 每秒刻数,
+               调度刻数);
+  调度对比("连射", 5, 200);
+  调度对比("点射 (多数枪大部分时间不开火)", 1, 5);
+}
+
+struct 基准项 {
+  std::string_view 名称;
+  void (*函数)();
+};
+
+constexpr 基准项 全部基准[] = {
+    {"射击/unique_ptr", 基准_堆射击},
+    {"射击/子弹池", 基准_池化射击},
+    {"射击/子弹值", 基准_值射击},
+    {"齐射", 基准_齐射},
+    {"武器查找", 基准_武器查找},
+    {"多线程射击", 基准_多线程射击},
+    {"伤害随机数", 基准_伤害随机数},
+    {"预热射击", 基准_预热射击},
+    {"开火调度", 基准_开火调度},
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string_view 选择 = argc > 1 ? argv[1] : "";
+  for (const auto &项 : 全部基准) {
+    if (选择.empty() || 选择 == 项.名称)
+      项.函数();
+  }
+  return 0;
+}
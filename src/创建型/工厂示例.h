@@ -0,0 +1,401 @@
+// 工厂示例.h
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <print>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+struct 子弹 {
+  virtual void 激发() = 0;
+  virtual ~子弹() = default;
+};
+
+struct 实体子弹 : 子弹 {
+  void 激发() override { std::println("物理伤害"); }
+};
+
+struct 能量子弹 : 子弹 {
+  void 激发() override { std::println("能量伤害"); }
+};
+
+struct ak47子弹 : 子弹 {
+  int 攻击力 = 0;
+  ak47子弹(int 攻击力) : 攻击力(攻击力) {}
+  void 激发() override { std::println("造成{}点物理伤害", 攻击力); }
+};
+
+// 带复杂参数的子弹
+struct 元素子弹 : 子弹 {
+  std::string 元素;
+  int 伤害;
+  元素子弹(std::string 元素, int 伤害) : 元素(std::move(元素)), 伤害(伤害) {}
+  void 激发() override { std::println("{}元素伤害: {}点", 元素, 伤害); }
+};
+
+// 使用初始化列表构造的子弹
+struct 霰弹 : 子弹 {
+  std::vector<int> 弹丸;
+  霰弹(std::initializer_list<int> 弹丸) : 弹丸(弹丸) {}
+  explicit 霰弹(std::vector<int> 弹丸) : 弹丸(std::move(弹丸)) {}
+  void 激发() override {
+    std::print("霰弹发射: ");
+    for (int d : 弹丸)
+      std::print("{} ", d);
+    std::println("");
+  }
+};
+
+// 子弹值: 值语义的类型擦除子弹, 小类型直接放在内联缓冲区里, 不做堆分配
+// 超出内联容量、对齐要求过高或移动可能抛异常的类型才退回到堆上
+class 子弹值 {
+public:
+  static constexpr std::size_t 内联容量 = 32;
+  static constexpr std::size_t 内联对齐 = alignof(std::max_align_t);
+
+  template <typename 子弹类>
+  static constexpr bool 可内联 =
+      sizeof(子弹类) <= 内联容量 && alignof(子弹类) <= 内联对齐 &&
+      std::is_nothrow_move_constructible_v<子弹类>;
+
+private:
+  // 手写虚表: 每种具体类型和存储方式各有一份静态常量
+  struct 操作表 {
+    void (*移动)(子弹值 &目标, 子弹值 &源) noexcept;
+    void (*析构)(子弹值 &自身) noexcept;
+  };
+
+  template <typename 子弹类>
+  static void 内联移动(子弹值 &目标, 子弹值 &源) noexcept {
+    auto *源对象 = static_cast<子弹类 *>(源.对象);
+    目标.对象 = ::new (目标.缓冲) 子弹类(std::move(*源对象));
+    源对象->子弹类::~子弹类();
+  }
+  template <typename 子弹类> static void 内联析构(子弹值 &自身) noexcept {
+    static_cast<子弹类 *>(自身.对象)->子弹类::~子弹类();
+  }
+  template <typename 子弹类> static void 堆析构(子弹值 &自身) noexcept {
+    auto *对象 = static_cast<子弹类 *>(自身.对象);
+    对象->子弹类::~子弹类();
+    std::allocator<子弹类>{}.deallocate(对象, 1);
+  }
+  static void 转移指针(子弹值 &目标, 子弹值 &源) noexcept {
+    目标.对象 = 源.对象;
+  }
+  // 接管 unique_ptr<子弹> 时具体类型未知, 只能经虚析构释放
+  static void 虚析构(子弹值 &自身) noexcept { delete 自身.对象; }
+
+  template <typename 子弹类>
+  static constexpr 操作表 内联操作{内联移动<子弹类>, 内联析构<子弹类>};
+  template <typename 子弹类>
+  static constexpr 操作表 堆操作{转移指针, 堆析构<子弹类>};
+  static constexpr 操作表 接管操作{转移指针, 虚析构};
+
+  子弹 *对象 = nullptr; // 指向内联缓冲区或堆上的子弹
+  const 操作表 *操作 = nullptr;
+  alignas(内联对齐) std::byte 缓冲[内联容量];
+
+  void 释放() noexcept {
+    if (操作) {
+      操作->析构(*this);
+      对象 = nullptr;
+      操作 = nullptr;
+    }
+  }
+
+  void 接收(子弹值 &源) noexcept {
+    if (源.操作) {
+      源.操作->移动(*this, 源);
+      操作 = std::exchange(源.操作, nullptr);
+      源.对象 = nullptr;
+    }
+  }
+
+public:
+  子弹值() = default;
+
+  // 接管已有的堆上子弹
+  explicit 子弹值(std::unique_ptr<子弹> 堆子弹)
+      : 对象(堆子弹.release()), 操作(对象 ? &接管操作 : nullptr) {}
+
+  // 调用 构造(void*) 在合适的存储上构造 子弹类
+  template <std::derived_from<子弹> 子弹类, typename 构造函数类型>
+  static 子弹值 就地创建(构造函数类型 &&构造) {
+    子弹值 结果;
+    if constexpr (可内联<子弹类>) {
+      结果.对象 = std::forward<构造函数类型>(构造)(结果.缓冲);
+      结果.操作 = &内联操作<子弹类>;
+    } else {
+      std::allocator<子弹类> 分配器;
+      子弹类 *存储 = 分配器.allocate(1);
+      try {
+        结果.对象 = std::forward<构造函数类型>(构造)(存储);
+      } catch (...) {
+        分配器.deallocate(存储, 1);
+        throw;
+      }
+      结果.操作 = &堆操作<子弹类>;
+    }
+    return 结果;
+  }
+
+  template <std::derived_from<子弹> 子弹类, typename... 参数类型>
+    requires std::constructible_from<子弹类, 参数类型...>
+  static 子弹值 创建(参数类型 &&...参数) {
+    return 就地创建<子弹类>([&](void *存储) {
+      return ::new (存储) 子弹类(std::forward<参数类型>(参数)...);
+    });
+  }
+
+  子弹值(子弹值 &&其他) noexcept { 接收(其他); }
+  子弹值 &operator=(子弹值 &&其他) noexcept {
+    if (this != &其他) {
+      释放();
+      接收(其他);
+    }
+    return *this;
+  }
+  子弹值(const 子弹值 &) = delete;
+  子弹值 &operator=(const 子弹值 &) = delete;
+  ~子弹值() { 释放(); }
+
+  子弹 *operator->() const { return 对象; }
+  子弹 &operator*() const { return *对象; }
+  explicit operator bool() const { return 对象 != nullptr; }
+  bool 内联存储() const {
+    return 对象 == static_cast<const void *>(缓冲);
+  }
+};
+
+class 枪 {
+public:
+  // 智能指针 自动管理内存
+  virtual std::unique_ptr<子弹> 射击() = 0;
+  // 按值返回子弹; 默认包装 射击() 的结果, 具体枪可以跳过堆分配
+  virtual 子弹值 射击值() { return 子弹值(射击()); }
+  // 一次齐射 数量 发子弹; 默认逐发射击, 具体枪可以整批处理
+  virtual void 齐射(std::size_t 数量) {
+    for (std::size_t i = 0; i < 数量; ++i)
+      射击()->激发();
+  }
+  virtual ~枪() = default;
+};
+
+// 子弹批: 连续存放同一具体类型子弹的缓冲区, 一次齐射只分配一次
+template <std::derived_from<子弹> 子弹类> class 子弹批 {
+  子弹类 *数据 = nullptr;
+  std::size_t 数量 = 0;
+  std::size_t 容量 = 0;
+
+public:
+  子弹批() = default;
+  explicit 子弹批(std::size_t 容量) { 预留(容量); }
+  ~子弹批() {
+    清空();
+    if (数据)
+      std::allocator<子弹类>{}.deallocate(数据, 容量);
+  }
+
+  子弹批(子弹批 &&其他) noexcept
+      : 数据(std::exchange(其他.数据, nullptr)),
+        数量(std::exchange(其他.数量, 0)),
+        容量(std::exchange(其他.容量, 0)) {}
+  子弹批 &operator=(子弹批 &&其他) noexcept {
+    std::swap(数据, 其他.数据);
+    std::swap(数量, 其他.数量);
+    std::swap(容量, 其他.容量);
+    return *this;
+  }
+  子弹批(const 子弹批 &) = delete;
+  子弹批 &operator=(const 子弹批 &) = delete;
+
+  // 只能在空批上扩容, 已构造的子弹不会被搬动
+  void 预留(std::size_t 新容量) {
+    assert(数量 == 0);
+    if (新容量 <= 容量)
+      return;
+    std::allocator<子弹类> 分配器;
+    子弹类 *新数据 = 分配器.allocate(新容量);
+    if (数据)
+      分配器.deallocate(数据, 容量);
+    数据 = 新数据;
+    容量 = 新容量;
+  }
+
+  // 在下一个空位上调用 构造(void*) 构造子弹
+  template <typename 构造函数类型> 子弹类 &就地追加(构造函数类型 &&构造) {
+    assert(数量 < 容量);
+    子弹类 *子弹实例 = std::forward<构造函数类型>(构造)(数据 + 数量);
+    ++数量;
+    return *子弹实例;
+  }
+
+  void 清空() noexcept {
+    for (std::size_t i = 0; i < 数量; ++i)
+      数据[i].子弹类::~子弹类();
+    数量 = 0;
+  }
+
+  std::span<子弹类> 视图() { return {数据, 数量}; }
+  std::size_t 大小() const { return 数量; }
+  子弹类 *begin() { return 数据; }
+  子弹类 *end() { return 数据 + 数量; }
+};
+
+// 批量激发: 具体类型在编译期已知, 逐个以限定名调用, 不经过虚表
+template <std::derived_from<子弹> 子弹类>
+void 激发批量(std::span<子弹类> 子弹列表) {
+  for (子弹类 &子弹实例 : 子弹列表)
+    子弹实例.子弹类::激发();
+}
+
+// 使用模板批量制造子弹工厂
+// 使用概念库 <concepts>约束为从子弹派生的类型  std::derived_from<子弹>子弹类
+template <std::derived_from<子弹> 子弹类> class 子弹枪 : public 枪 {
+
+  // 使用 move_only_function 更高效
+  using 创建函数类型 = std::move_only_function<std::unique_ptr<子弹类>()>;
+  using 值创建函数类型 = std::move_only_function<子弹类()>;
+  using 就地创建函数类型 = std::move_only_function<子弹类 *(void *)>;
+  using 批量创建函数类型 =
+      std::move_only_function<void(子弹批<子弹类> &, std::size_t)>;
+  创建函数类型 创建函数;
+  // 在调用方提供的内存上构造子弹, 供对象池等不走堆分配的路径使用
+  就地创建函数类型 就地创建函数;
+  // 整批构造: 一次间接调用进入, 循环内按具体类型直接构造
+  批量创建函数类型 批量创建函数;
+  // 齐射复用的缓冲区, 避免每次齐射重新分配
+  子弹批<子弹类> 齐射缓冲;
+
+  // 把单发构造包装成整批构造, 循环体里 构造 的类型已知, 可以内联
+  template <typename 构造函数类型>
+  static 批量创建函数类型 逐个构造(构造函数类型 构造) {
+    return [构造 = std::move(构造)](子弹批<子弹类> &输出,
+                                    std::size_t 数量) mutable {
+      for (std::size_t i = 0; i < 数量; ++i)
+        输出.就地追加(构造);
+    };
+  }
+
+public:
+  // 默认构造 (无参)
+  子弹枪() : 创建函数([] { return std::make_unique<子弹类>(); }) {
+    auto 构造 = [](void *存储) { return ::new (存储) 子弹类(); };
+    就地创建函数 = 构造;
+    批量创建函数 = 逐个构造(构造);
+  }
+
+  // 带参数构造 - 使用完美转发
+  template <typename... 参数类型>
+    requires std::constructible_from<子弹类, 参数类型...>
+  explicit 子弹枪(参数类型 &&...参数) {
+    using 存储类型 = std::tuple<std::decay_t<参数类型>...>;
+    auto 参数存储 = std::make_shared<存储类型>(std::forward<参数类型>(参数)...);
+
+    创建函数 = [参数存储] {
+      return std::apply(
+          [](auto &&...args) {
+            return std::make_unique<子弹类>(
+                std::forward<decltype(args)>(args)...);
+          },
+          *参数存储);
+    };
+    auto 构造 = [参数存储](void *存储) {
+      return std::apply(
+          [存储](auto &&...args) {
+            return ::new (存储) 子弹类(std::forward<decltype(args)>(args)...);
+          },
+          *参数存储);
+    };
+    就地创建函数 = 构造;
+    批量创建函数 = 逐个构造(构造);
+  }
+  // 初始化列表专用构造函数
+  // initializer_list 的底层数组在构造语句结束后即失效, 不能被捕获保存,
+  // 因此先构造一枚原型子弹, 之后每次射击复制它
+  template <typename T>
+    requires requires(std::initializer_list<T> il) {
+      { std::make_unique<子弹类>(il) } -> std::same_as<std::unique_ptr<子弹类>>;
+    } && std::copy_constructible<子弹类>
+  explicit 子弹枪(std::initializer_list<T> il) {
+    std::shared_ptr<const 子弹类> 原型 = std::make_shared<子弹类>(il);
+    创建函数 = [原型] { return std::make_unique<子弹类>(*原型); };
+    auto 构造 = [原型](void *存储) { return ::new (存储) 子弹类(*原型); };
+    就地创建函数 = 构造;
+    批量创建函数 = 逐个构造(构造);
+  }
+
+  // 支持工厂函数作为参数
+  // 工厂返回堆对象, 没有整批路径, 射击批量 退回逐发 就地射击
+  explicit 子弹枪(创建函数类型 工厂函数) : 创建函数(std::move(工厂函数)) {}
+
+  // 支持按值返回子弹的工厂函数, 就地构造时不经过堆
+  // 每发子弹仍要调用一次用户工厂, 整批路径只省去外层的间接调用
+  explicit 子弹枪(值创建函数类型 工厂函数) {
+    auto 工厂 = std::make_shared<值创建函数类型>(std::move(工厂函数));
+    创建函数 = [工厂] { return std::make_unique<子弹类>((*工厂)()); };
+    auto 构造 = [工厂](void *存储) { return ::new (存储) 子弹类((*工厂)()); };
+    就地创建函数 = 构造;
+    批量创建函数 = 逐个构造(构造);
+  }
+
+  // 移动操作
+  子弹枪(子弹枪 &&) = default;
+  子弹枪 &operator=(子弹枪 &&) = default;
+
+  // 禁止复制
+  子弹枪(const 子弹枪 &) = delete;
+  子弹枪 &operator=(const 子弹枪 &) = delete;
+
+  std::unique_ptr<子弹> 射击() override { return 创建函数(); }
+
+  // 在 存储 指向的未初始化内存上构造一枚子弹
+  // 返回堆对象的工厂函数无法就地构造, 只能把它的结果移动过来
+  子弹类 *就地射击(void *存储) {
+    if (就地创建函数)
+      return 就地创建函数(存储);
+    return ::new (存储) 子弹类(std::move(*创建函数()));
+  }
+
+  // 小子弹直接构造在返回值的内联缓冲区里
+  子弹值 射击值() override {
+    return 子弹值::就地创建<子弹类>(
+        [this](void *存储) { return 就地射击(存储); });
+  }
+
+  // 把 数量 发子弹连续构造到 输出 中 (先清空输出)
+  void 射击批量(std::size_t 数量, 子弹批<子弹类> &输出) {
+    输出.清空();
+    输出.预留(数量);
+    if (批量创建函数) {
+      批量创建函数(输出, 数量);
+      return;
+    }
+    for (std::size_t i = 0; i < 数量; ++i)
+      输出.就地追加([this](void *存储) { return 就地射击(存储); });
+  }
+
+  子弹批<子弹类> 射击批量(std::size_t 数量) {
+    子弹批<子弹类> 输出;
+    射击批量(数量, 输出);
+    return 输出;
+  }
+
+  // 整批构造再整批激发: 每次齐射一次虚调用加一次批量构造的间接调用,
+  // 单发子弹的构造和激发都不再经过间接调用 (按值工厂除外)
+  void 齐射(std::size_t 数量) override {
+    射击批量(数量, 齐射缓冲);
+    激发批量(齐射缓冲.视图());
+    齐射缓冲.清空();
+  }
+};
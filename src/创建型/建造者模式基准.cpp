@@ -0,0 +1,342 @@
+// 建造者模式基准.cpp
+// 用法: 建造者模式基准 [基准名]   不带参数时运行全部基准
+// 请在 release 模式下构建: xmake f -m release && xmake run 建造者模式基准
+#include "基准工具.h"
+#include "建造者示例.h"
+#include "异步角色导演.h"
+#include "角色名册.h"
+#include "角色原型库.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t 生成数量 = 1'000'000;
+// 同时存活的角色数: 新角色替换最早的一个, 迫使旧角色被释放
+constexpr std::size_t 存活角色数 = 10'000;
+
+// 三种职业轮流生成
+template <typename 生成函数类型>
+double 连续生成(生成函数类型 &&生成) {
+  using 角色类型 = decltype(生成.template operator()<战士建造者>());
+  std::vector<角色类型> 存活(存活角色数);
+  return 基准计时([&] {
+    for (std::size_t i = 0; i < 生成数量; i += 3) {
+      存活[i % 存活角色数] = 生成.template operator()<战士建造者>();
+      存活[(i + 1) % 存活角色数] = 生成.template operator()<法师建造者>();
+      存活[(i + 2) % 存活角色数] = 生成.template operator()<弓箭手建造者>();
+      防止优化(存活[i % 存活角色数]);
+    }
+  });
+}
+
+void 报告(std::string_view 名称, double 秒, double 基线秒) {
+  std::println("  {:<20} {:>8.2f} 纳秒/个  {:>6.2f}x", 名称,
+               秒 / 生成数量 * 1e9, 基线秒 / 秒);
+}
+
+void 基准_角色生成() {
+  std::println("[角色生成] {} 个角色, {} 个同时存活", 生成数量, 存活角色数);
+  double 逐步秒 = 连续生成(
+      []<角色建造者概念 T>() { return 按步骤创建角色<T>(); });
+  double 原型秒 = 连续生成([]<角色建造者概念 T>() { return 创建角色<T>(); });
+  double 值秒 =
+      连续生成([]<角色建造者概念 T>() -> 游戏角色 { return 角色原型<T>(); });
+  报告("逐步构建 (unique_ptr)", 逐步秒, 逐步秒);
+  报告("原型复制 (unique_ptr)", 原型秒, 逐步秒);
+  报告("原型复制 (值)", 值秒, 逐步秒);
+}
+
+constexpr std::size_t 波次人数 = 100'000;
+
+void 基准_批量生成() {
+  std::println("[批量生成] 每波 {} 个角色 (三种职业各三分之一)", 波次人数);
+  const std::size_t 每职业 = 波次人数 / 3;
+
+  auto 内存前 = 常驻内存字节();
+  std::vector<std::unique_ptr<游戏角色>> 逐个;
+  double 逐个秒 = 基准计时([&] {
+    逐个.reserve(每职业 * 3);
+    for (std::size_t i = 0; i < 每职业; ++i)
+      逐个.push_back(创建角色<战士建造者>());
+    for (std::size_t i = 0; i < 每职业; ++i)
+      逐个.push_back(创建角色<法师建造者>());
+    for (std::size_t i = 0; i < 每职业; ++i)
+      逐个.push_back(创建角色<弓箭手建造者>());
+  });
+  auto 逐个内存 = 常驻内存字节() - 内存前;
+
+  内存前 = 常驻内存字节();
+  角色名册 名册;
+  double 名册秒 = 基准计时([&] {
+    创建角色批量<战士建造者>(名册, 每职业);
+    创建角色批量<法师建造者>(名册, 每职业);
+    创建角色批量<弓箭手建造者>(名册, 每职业);
+  });
+  auto 名册内存 = 常驻内存字节() - 内存前;
+
+  // 遍历全体: 统计持巨剑的角色数与等级总和
+  long long 逐个等级 = 0, 逐个巨剑 = 0;
+  double 逐个遍历秒 = 基准计时([&] {
+    for (const auto &角色 : 逐个) {
+      逐个等级 += 角色->获取等级();
+      逐个巨剑 += 角色->获取武器() == "巨剑";
+    }
+  });
+
+  long long 名册等级 = 0, 名册巨剑 = 0;
+  double 名册遍历秒 = 基准计时([&] {
+    名称表::编号 巨剑;
+    bool 存在 = 名册.名称索引().查找("巨剑", 巨剑);
+    for (std::size_t 批号 = 0; 批号 < 名册.批数(); ++批号) {
+      const 角色批 &批 = 名册.批(批号);
+      for (std::uint16_t 等级 : 批.等级列())
+        名册等级 += 等级;
+      if (存在)
+        名册巨剑 += std::ranges::count(批.武器列(), 巨剑);
+    }
+  });
+  防止优化(逐个等级 + 逐个巨剑 + 名册等级 + 名册巨剑);
+
+  auto MiB = [](std::size_t 字节) { return 字节 / (1024.0 * 1024.0); };
+  std::println("  逐个 unique_ptr  生成 {:>8.2f} 毫秒  内存 {:>8.2f} MiB  遍历 "
+               "{:>8.3f} 毫秒",
+               逐个秒 * 1e3, MiB(逐个内存), 逐个遍历秒 * 1e3);
+  std::println("  列式名册         生成 {:>8.2f} 毫秒  内存 {:>8.2f} MiB  遍历 "
+               "{:>8.3f} 毫秒",
+               名册秒 * 1e3, MiB(名册内存), 名册遍历秒 * 1e3);
+  std::println("  结果{}: 等级总和 {}, 持巨剑 {}",
+               逐个等级 == 名册等级 && 逐个巨剑 == 名册巨剑 ? "一致" : "不一致",
+               名册等级, 名册巨剑);
+}
+
+constexpr std::size_t 查询人数 = 300'000;
+constexpr int 查询轮数 = 20;
+
+// 对照组: 每个角色一份技能名称列表, 逐个比较字符串
+using 名称技能列表 = std::vector<std::string>;
+
+bool 名称拥有(const 名称技能列表 &列表, std::string_view 技能) {
+  return std::ranges::find(列表, 技能) != 列表.end();
+}
+
+void 基准_技能查询() {
+  std::println("[技能查询] {} 个角色, 每种查询 {} 轮", 查询人数, 查询轮数);
+  角色名册 名册;
+  const std::size_t 每职业 = 查询人数 / 3;
+  创建角色批量<战士建造者>(名册, 每职业);
+  创建角色批量<法师建造者>(名册, 每职业);
+  创建角色批量<弓箭手建造者>(名册, 每职业);
+
+  std::vector<名称技能列表> 名称列表;
+  名称列表.reserve(名册.大小());
+  for (std::size_t 批号 = 0; 批号 < 名册.批数(); ++批号) {
+    for (std::size_t i = 0; i < 名册.批(批号).大小(); ++i) {
+      auto &列表 = 名称列表.emplace_back();
+      名册.批(批号).技能(i).遍历([&](技能编号 技能) {
+        列表.emplace_back(技能库::全局().名称(技能));
+      });
+    }
+  }
+
+  auto &库 = 技能库::全局();
+  技能集 单个, 任一, 全部;
+  库.组成(单个, "火球术");
+  库.组成(任一, "冲锋", "多重射击");
+  库.组成(全部, "多重射击", "精准射击");
+
+  struct 查询 {
+    std::string_view 名称;
+    const 技能集 &条件;
+    角色名册::匹配方式 方式;
+    bool (*按名称)(const 名称技能列表 &);
+  };
+  const 查询 查询列表[] = {
+      {"拥有 火球术", 单个, 角色名册::匹配方式::全部,
+       [](const 名称技能列表 &列表) { return 名称拥有(列表, "火球术"); }},
+      {"拥有任一 冲锋/多重射击", 任一, 角色名册::匹配方式::任一,
+       [](const 名称技能列表 &列表) {
+         return 名称拥有(列表, "冲锋") || 名称拥有(列表, "多重射击");
+       }},
+      {"拥有全部 多重射击/精准射击", 全部, 角色名册::匹配方式::全部,
+       [](const 名称技能列表 &列表) {
+         return 名称拥有(列表, "多重射击") && 名称拥有(列表, "精准射击");
+       }},
+  };
+
+  for (const auto &项 : 查询列表) {
+    std::size_t 名称结果 = 0, 位集结果 = 0;
+    double 名称秒 = 基准计时([&] {
+      for (int 轮 = 0; 轮 < 查询轮数; ++轮) {
+        名称结果 = 0;
+        for (const auto &列表 : 名称列表)
+          名称结果 += 项.按名称(列表);
+        防止优化(名称结果);
+      }
+    });
+    double 位集秒 = 基准计时([&] {
+      for (int 轮 = 0; 轮 < 查询轮数; ++轮) {
+        位集结果 = 名册.统计(项.条件, 项.方式);
+        防止优化(位集结果);
+      }
+    });
+    std::println("  {}: 字符串 {:>8.3f} 毫秒  位集 {:>8.3f} 毫秒  {:>6.1f}x  "
+                 "命中 {}{}",
+                 项.名称, 名称秒 / 查询轮数 * 1e3, 位集秒 / 查询轮数 * 1e3,
+                 名称秒 / 位集秒, 位集结果,
+                 名称结果 == 位集结果 ? "" : " (结果不一致!)");
+  }
+}
+
+constexpr std::size_t 原型条数 = 50'000;
+
+// 生成一个包含 原型条数 个原型的定义文件
+std::filesystem::path 生成原型文件() {
+  auto 路径 = std::filesystem::temp_directory_path() / "角色原型基准.txt";
+  std::ofstream 输出(路径);
+  const char *职业[] = {"狂战士", "大法师", "神射手", "圣殿骑士", "暗影刺客"};
+  const char *武器[] = {"巨剑", "法杖", "长弓", "战锤", "双匕首", "木杖"};
+  const char *护甲[] = {"板甲", "布甲", "皮甲", "锁甲"};
+  const char *技能[] = {"旋风斩", "狂暴", "冲锋", "火球术", "寒冰箭",
+                        "传送术", "多重射击", "精准射击", "潜行", "背刺"};
+  for (std::size_t i = 0; i < 原型条数; ++i) {
+    输出 << std::format("原型{:05} {} {} {} {}", i, 职业[i % 5], 武器[i % 6],
+                        护甲[i % 4], 1 + i % 60);
+    for (std::size_t k = 0; k < 3 + i % 4; ++k)
+      输出 << ' ' << 技能[(i + k * 3) % 10];
+    输出 << '\n';
+  }
+  return 路径;
+}
+
+void 基准_原型加载() {
+  std::println("[原型加载] {} 个原型", 原型条数);
+  auto 源文件 = 生成原型文件();
+  std::filesystem::remove(角色原型库::缓存路径(源文件));
+
+  std::size_t 解析条数 = 0;
+  double 解析秒 = 基准计时([&] { 解析条数 = 角色原型库::解析(源文件).大小(); });
+
+  bool 冷来自缓存 = true, 热来自缓存 = false;
+  double 冷秒 = 基准计时(
+      [&] { 冷来自缓存 = 角色原型库::加载(源文件).来自缓存(); });
+  double 热秒 = 基准计时(
+      [&] { 热来自缓存 = 角色原型库::加载(源文件).来自缓存(); });
+
+  // 热启动后按名称生成角色
+  auto 库 = 角色原型库::加载(源文件);
+  double 生成秒 = 基准计时([&] {
+    for (std::size_t i = 0; i < 原型条数; i += 7)
+      防止优化(库.创建(std::format("原型{:05}", i)));
+  });
+
+  std::println("  仅解析文本          {:>8.2f} 毫秒  ({} 条)", 解析秒 * 1e3,
+               解析条数);
+  std::println("  冷启动 (解析+写缓存) {:>8.2f} 毫秒  来自缓存: {}", 冷秒 * 1e3,
+               冷来自缓存);
+  std::println("  热启动 (映射缓存)   {:>8.2f} 毫秒  来自缓存: {}", 热秒 * 1e3,
+               热来自缓存);
+  std::println("  按名称生成 {} 个角色  {:>8.2f} 毫秒", (原型条数 + 6) / 7,
+               生成秒 * 1e3);
+
+  std::filesystem::remove(角色原型库::缓存路径(源文件));
+  std::filesystem::remove(源文件);
+}
+
+// 模拟线上建造者: 武器/护甲要加载资源, 技能要查数据库, 用休眠代替等待
+using namespace std::chrono_literals;
+
+class 加载资源建造者 : public 角色建造者基类<加载资源建造者> {
+  friend class 角色建造者基类<加载资源建造者>;
+
+private:
+  void 构建职业实现() {
+    std::this_thread::sleep_for(1ms);
+    角色->设置职业("圣殿骑士");
+  }
+  void 构建武器实现() {
+    std::this_thread::sleep_for(2ms);
+    角色->设置武器("战锤");
+  }
+  void 构建护甲实现() {
+    std::this_thread::sleep_for(2ms);
+    角色->设置护甲("板甲");
+  }
+  void 构建等级实现() { 角色->设置等级(12); }
+  void 构建技能实现() {
+    std::this_thread::sleep_for(3ms);
+    角色->添加技能("圣光术");
+    角色->添加技能("神圣护盾");
+  }
+};
+
+constexpr int 异步构建数 = 64;
+constexpr std::size_t 异步线程数 = 16;
+
+void 基准_异步构建() {
+  std::println("[异步构建] {} 个角色, 每个 职业1+武器2+护甲2+技能3 毫秒等待, "
+               "{} 个工作线程",
+               异步构建数, 异步线程数);
+  double 同步秒 = 基准计时([] {
+    for (int i = 0; i < 异步构建数; ++i)
+      防止优化(按步骤创建角色<加载资源建造者>());
+  });
+
+  任务池 池(异步线程数);
+  异步角色导演 导演(池);
+  // 单个角色: 只能重叠同一角色内互不依赖的步骤
+  double 单个秒 = 基准计时([&] {
+    for (int i = 0; i < 异步构建数; ++i)
+      防止优化(导演.构建角色<加载资源建造者>().get());
+  });
+  // 整批: 所有角色的步骤一起排队, 等待时间相互重叠
+  double 整批秒 = 基准计时([&] {
+    std::vector<std::future<游戏角色>> 结果;
+    for (int i = 0; i < 异步构建数; ++i)
+      结果.push_back(导演.构建角色<加载资源建造者>());
+    for (auto &角色 : 结果)
+      防止优化(角色.get());
+  });
+
+  std::println("  同步逐步构建      {:>8.2f} 毫秒", 同步秒 * 1e3);
+  std::println("  异步 逐个等待     {:>8.2f} 毫秒  {:>6.2f}x", 单个秒 * 1e3,
+               同步秒 / 单个秒);
+  std::println("  异步 整批提交     {:>8.2f} 毫秒  {:>6.2f}x", 整批秒 * 1e3,
+               同步秒 / 整批秒);
+}
+
+struct 基准项 {
+  std::string_view 名称;
+  void (*函数)();
+};
+
+constexpr 基准项 全部基准[] = {
+    {"角色生成", 基准_角色生成},
+    {"批量生成", 基准_批量生成},
+    {"技能查询", 基准_技能查询},
+    {"原型加载", 基准_原型加载},
+    {"异步构建", 基准_异步构建},
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string_view 选择 = argc > 1 ? argv[1] : "";
+  for (const auto &项 : 全部基准) {
+    if (选择.empty() || 选择 == 项.名称)
+      项.函数();
+  }
+  return 0;
+}
@@ -0,0 +1,199 @@
+// 建造者示例.h
+// 游戏角色, 建造者与导演; 示例程序与基准共用
+#pragma once
+
+#include "技能库.h"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <print> // C++23 的格式化输出库
+#include <string>
+#include <string_view>
+
+// 游戏角色类 - 最终产品
+class 游戏角色 {
+public:
+  // 参数与成员同名, 必须经 this 访问成员
+  void 设置职业(std::string_view 职业) { this->职业 = 职业; }
+  void 设置武器(std::string_view 武器) { this->武器 = 武器; }
+  void 设置护甲(std::string_view 护甲) { this->护甲 = 护甲; }
+  void 设置等级(int 等级) { this->等级 = 等级; }
+  // 技能按名称登记到全局技能库, 角色只保存技能位集
+  void 添加技能(std::string_view 技能) {
+    this->技能.加入(技能库::全局().登记(技能));
+  }
+
+  void 显示属性() const {
+    using namespace std; // 允许使用println
+
+    println("\n🎮 角色创建完成:");
+    println("  🎭 职业: {}", 职业);
+    println("  ⚔️ 武器: {}", 武器);
+    println("  🛡️ 护甲: {}", 护甲);
+    println("  📈 等级: {}", 等级);
+
+    print("  🧪 技能: ");
+    const char *分隔 = "";
+    技能.遍历([&](技能编号 编号) {
+      print("{}{}", 分隔, 技能库::全局().名称(编号));
+      分隔 = ", ";
+    });
+    println("\n");
+  }
+
+  std::string_view 获取职业() const { return 职业; }
+  std::string_view 获取武器() const { return 武器; }
+  std::string_view 获取护甲() const { return 护甲; }
+  int 获取等级() const { return 等级; }
+  const 技能集 &获取技能() const { return 技能; }
+
+private:
+  std::string 职业{"未选择"};
+  std::string 武器{"无"};
+  std::string 护甲{"无"};
+  int 等级{1};
+  技能集 技能;
+};
+
+// 建造者概念定义
+template <typename T>
+concept 角色建造者概念 = requires(T t) {
+  { t.构建职业() } -> std::same_as<void>;
+  { t.构建武器() } -> std::same_as<void>;
+  { t.构建护甲() } -> std::same_as<void>;
+  { t.构建等级() } -> std::same_as<void>;
+  { t.构建技能() } -> std::same_as<void>;
+  { t.获取角色() } -> std::convertible_to<std::unique_ptr<游戏角色>>;
+};
+
+// 构建步骤, 按 执行构建步骤 的顺序编号
+enum class 构建步骤 : std::uint8_t { 职业, 武器, 护甲, 等级, 技能 };
+inline constexpr std::size_t 构建步骤数 = 5;
+
+// 步骤依赖表: 第 i 项的第 j 位表示步骤 i 必须在步骤 j 完成之后执行
+using 步骤依赖表 = std::array<std::uint8_t, 构建步骤数>;
+
+constexpr std::uint8_t 依赖于(std::same_as<构建步骤> auto... 步骤) {
+  return static_cast<std::uint8_t>(
+      ((1u << static_cast<unsigned>(步骤)) | ... | 0u));
+}
+
+// 建造者基类模板 (使用CRTP模式)
+template <typename 角色建造者类型> class 角色建造者基类 {
+protected:
+  std::unique_ptr<游戏角色> 角色 = std::make_unique<游戏角色>();
+
+public:
+  // 异步导演据此并行执行互不依赖的步骤; 具体建造者可以定义同名成员覆盖
+  // 默认: 技能取决于职业和等级, 其余步骤互不依赖
+  static constexpr 步骤依赖表 步骤依赖{
+      0, 0, 0, 0, 依赖于(构建步骤::职业, 构建步骤::等级)};
+
+  virtual ~角色建造者基类() = default;
+
+  void 构建职业() { static_cast<角色建造者类型 *>(this)->构建职业实现(); }
+  void 构建武器() { static_cast<角色建造者类型 *>(this)->构建武器实现(); }
+  void 构建护甲() { static_cast<角色建造者类型 *>(this)->构建护甲实现(); }
+  void 构建等级() { static_cast<角色建造者类型 *>(this)->构建等级实现(); }
+  void 构建技能() { static_cast<角色建造者类型 *>(this)->构建技能实现(); }
+
+  std::unique_ptr<游戏角色> 获取角色() { return std::move(角色); }
+};
+
+// 战士建造者
+class 战士建造者 : public 角色建造者基类<战士建造者> {
+  friend class 角色建造者基类<战士建造者>;
+
+private:
+  void 构建职业实现() { 角色->设置职业("狂战士"); }
+  void 构建武器实现() { 角色->设置武器("巨剑"); }
+  void 构建护甲实现() { 角色->设置护甲("板甲"); }
+  void 构建等级实现() { 角色->设置等级(10); }
+  void 构建技能实现() {
+    角色->添加技能("旋风斩");
+    角色->添加技能("狂暴");
+    角色->添加技能("冲锋");
+  }
+};
+
+// 法师建造者
+class 法师建造者 : public 角色建造者基类<法师建造者> {
+  friend class 角色建造者基类<法师建造者>;
+
+private:
+  void 构建职业实现() { 角色->设置职业("大法师"); }
+  void 构建武器实现() { 角色->设置武器("法杖"); }
+  void 构建护甲实现() { 角色->设置护甲("布甲"); }
+  void 构建等级实现() { 角色->设置等级(8); }
+  void 构建技能实现() {
+    角色->添加技能("火球术");
+    角色->添加技能("寒冰箭");
+    角色->添加技能("传送术");
+  }
+};
+
+// 弓箭手建造者
+class 弓箭手建造者 : public 角色建造者基类<弓箭手建造者> {
+  friend class 角色建造者基类<弓箭手建造者>;
+
+private:
+  void 构建职业实现() { 角色->设置职业("神射手"); }
+  void 构建武器实现() { 角色->设置武器("长弓"); }
+  void 构建护甲实现() { 角色->设置护甲("皮甲"); }
+  void 构建等级实现() { 角色->设置等级(7); }
+  void 构建技能实现() {
+    角色->添加技能("多重射击");
+    角色->添加技能("精准射击");
+    角色->添加技能("陷阱布置");
+  }
+};
+
+// 按固定顺序执行全部构建步骤
+template <角色建造者概念 T> void 执行构建步骤(T &建造者) {
+  建造者.构建职业();
+  建造者.构建武器();
+  建造者.构建护甲();
+  建造者.构建等级();
+  建造者.构建技能();
+}
+
+// 导演类模板 - 修复构造函数问题
+template <角色建造者概念 T> class 角色导演 {
+public:
+  // 添加构造函数解决诊断问题
+  角色导演(T &建造者) : 建造者(&建造者) {}
+
+  void 构建角色() {
+    std::println("开始构建角色...");
+    执行构建步骤(*建造者);
+    std::println("角色构建完成 ✅");
+  }
+
+  std::unique_ptr<游戏角色> 获取角色() { return 建造者->获取角色(); }
+
+private:
+  T *建造者;
+};
+
+// 每次都完整执行一遍建造者; 适用于输出随参数变化的建造者
+template <角色建造者概念 T> std::unique_ptr<游戏角色> 按步骤创建角色() {
+  T 建造者;
+  执行构建步骤(建造者);
+  return 建造者.获取角色();
+}
+
+// 角色原型表: 每种预设建造者只在首次使用时构建一次, 之后只读
+// 字符串和技能列表需要堆内存, 无法在编译期构建后留到运行期, 所以放在首次使用时
+// 局部静态变量的初始化是线程安全的
+template <角色建造者概念 T> const 游戏角色 &角色原型() {
+  static const 游戏角色 原型 = std::move(*按步骤创建角色<T>());
+  return 原型;
+}
+
+// 角色创建工厂函数: 从原型复制一份
+template <角色建造者概念 T> std::unique_ptr<游戏角色> 创建角色() {
+  return std::make_unique<游戏角色>(角色原型<T>());
+}
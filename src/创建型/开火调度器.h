@@ -0,0 +1,215 @@
+// 开火调度器.h
+// 按射速调度大量枪: 分层时间轮, 每刻只处理到期的枪, 登记/取消均为 O(1)
+#pragma once
+
+#include "工厂示例.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// 调度句柄: 节点编号 + 代数, 节点被复用后旧句柄自动失效
+struct 开火句柄 {
+  std::uint32_t 编号 = UINT32_MAX;
+  std::uint32_t 代数 = 0;
+};
+
+struct 调度统计 {
+  std::uint64_t 刻数 = 0;
+  std::uint64_t 到期总数 = 0;
+  std::uint64_t 级联移动数 = 0; // 高层轮降级到低层轮的节点数
+  double 调度秒数 = 0;         // 不含开火回调本身的耗时
+};
+
+// 4 层, 每层 64 槽, 可表示 2^24 刻以内的间隔
+class 开火调度器 {
+public:
+  static constexpr std::uint32_t 每层位数 = 6;
+  static constexpr std::uint32_t 每层槽数 = 1u << 每层位数;
+  static constexpr std::uint32_t 层数 = 4;
+  static constexpr std::uint64_t 最大间隔 = (1ull << (每层位数 * 层数)) - 1;
+
+  // 每过 间隔刻数 开火一次, 每次齐射 每次发数 发
+  开火句柄 登记(枪 &枪实例, std::uint64_t 间隔刻数,
+                std::uint32_t 每次发数 = 1) {
+    if (间隔刻数 == 0 || 间隔刻数 > 最大间隔)
+      throw std::invalid_argument("开火间隔超出时间轮范围");
+    std::uint32_t 编号 = 分配节点();
+    节点 &项 = 节点列表[编号];
+    项.目标 = &枪实例;
+    项.间隔 = 间隔刻数;
+    项.每次发数 = 每次发数;
+    项.到期 = 当前刻 + 间隔刻数;
+    插入(编号);
+    ++登记数;
+    return {编号, 项.代数};
+  }
+
+  // 按射速 (发/秒) 和每秒刻数登记, 间隔向上取整且至少为 1 刻
+  开火句柄 按射速登记(枪 &枪实例, double 射速, double 每秒刻数,
+                      std::uint32_t 每次发数 = 1) {
+    if (射速 <= 0)
+      throw std::invalid_argument("射速必须为正数");
+    auto 间隔 = static_cast<std::uint64_t>(每秒刻数 / 射速 + 0.999999);
+    return 登记(枪实例, 间隔 > 0 ? 间隔 : 1, 每次发数);
+  }
+
+  // 取消调度; 句柄已失效时返回 false
+  bool 取消(开火句柄 句柄) {
+    if (句柄.编号 >= 节点列表.size())
+      return false;
+    节点 &项 = 节点列表[句柄.编号];
+    if (项.代数 != 句柄.代数 || 项.槽号 == 无)
+      return false;
+    if (项.槽号 != 到期中)
+      摘除(句柄.编号);
+    释放节点(句柄.编号);
+    --登记数;
+    return true;
+  }
+
+  // 推进一刻, 把到期的枪整批交给 处理批次(std::span<枪 *const>, 发数列表)
+  // 处理完后按各自间隔重新入轮; 回调中可以登记或取消
+  template <typename 处理函数类型> void 推进(处理函数类型 &&处理批次) {
+    auto 开始 = std::chrono::steady_clock::now();
+    ++当前刻;
+    // 低层轮转完一圈时, 从高层轮取出对应槽位降级
+    for (std::uint32_t 层 = 1; 层 < 层数; ++层) {
+      if ((当前刻 & ((1ull << (每层位数 * 层)) - 1)) != 0)
+        break;
+      级联(层, (当前刻 >> (每层位数 * 层)) & (每层槽数 - 1));
+    }
+
+    // 整槽换出, 槽位本身换入上一刻用过的空缓冲, 两边都不重新分配
+    到期编号.clear();
+    到期编号.swap(槽列表[当前刻 & (每层槽数 - 1)]);
+    到期批次.resize(到期编号.size());
+    到期发数.resize(到期编号.size());
+    for (std::size_t i = 0; i < 到期编号.size(); ++i) {
+      节点 &项 = 节点列表[到期编号[i]];
+      到期批次[i] = 项.目标;
+      到期发数[i] = 项.每次发数;
+      项.槽号 = 到期中;
+    }
+    统计.到期总数 += 到期批次.size();
+    统计.调度秒数 += 秒数(开始);
+
+    if (!到期批次.empty())
+      处理批次(std::span<枪 *const>(到期批次),
+               std::span<const std::uint32_t>(到期发数));
+
+    开始 = std::chrono::steady_clock::now();
+    for (std::uint32_t 编号 : 到期编号) {
+      节点 &项 = 节点列表[编号];
+      if (项.槽号 != 到期中)
+        continue; // 回调中被取消 (节点可能已被重新登记)
+      项.到期 = 当前刻 + 项.间隔;
+      插入(编号);
+    }
+    ++统计.刻数;
+    统计.调度秒数 += 秒数(开始);
+  }
+
+  // 默认处理: 每把到期的枪齐射一次
+  void 推进() {
+    推进([](std::span<枪 *const> 批次, std::span<const std::uint32_t> 发数) {
+      for (std::size_t i = 0; i < 批次.size(); ++i)
+        批次[i]->齐射(发数[i]);
+    });
+  }
+
+  std::uint64_t 当前() const { return 当前刻; }
+  std::size_t 数量() const { return 登记数; }
+  const 调度统计 &获取统计() const { return 统计; }
+  void 重置统计() { 统计 = {}; }
+
+private:
+  static constexpr std::uint32_t 无 = UINT32_MAX;
+  static constexpr std::uint32_t 到期中 = UINT32_MAX - 1; // 已取出, 等待重新入轮
+
+  struct 节点 {
+    枪 *目标 = nullptr;
+    std::uint64_t 间隔 = 0;
+    std::uint64_t 到期 = 0;
+    std::uint32_t 每次发数 = 1;
+    std::uint32_t 槽号 = 无;   // 所在槽 (层 * 每层槽数 + 槽); 未入轮为 无
+    std::uint32_t 槽内位置 = 0; // 在槽列表中的下标, 取消时交换删除
+    std::uint32_t 代数 = 0;
+  };
+
+  std::vector<节点> 节点列表;
+  std::vector<std::uint32_t> 空闲节点;
+  // 每个槽存节点编号数组: 遍历到期槽是顺序读, 不用沿链表逐个追指针
+  std::array<std::vector<std::uint32_t>, 层数 * 每层槽数> 槽列表;
+  std::uint64_t 当前刻 = 0;
+  std::size_t 登记数 = 0;
+  调度统计 统计;
+
+  // 每刻复用的到期批次缓冲
+  std::vector<枪 *> 到期批次;
+  std::vector<std::uint32_t> 到期发数;
+  std::vector<std::uint32_t> 到期编号;
+  std::vector<std::uint32_t> 级联缓冲;
+
+  static double 秒数(std::chrono::steady_clock::time_point 开始) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         开始)
+        .count();
+  }
+
+  std::uint32_t 分配节点() {
+    if (!空闲节点.empty()) {
+      std::uint32_t 编号 = 空闲节点.back();
+      空闲节点.pop_back();
+      return 编号;
+    }
+    节点列表.emplace_back();
+    return static_cast<std::uint32_t>(节点列表.size() - 1);
+  }
+
+  void 释放节点(std::uint32_t 编号) {
+    节点 &项 = 节点列表[编号];
+    项.目标 = nullptr;
+    项.槽号 = 无;
+    ++项.代数;
+    空闲节点.push_back(编号);
+  }
+
+  // 按到期时间与当前刻的距离选层, 槽位取到期时间在该层的对应位段
+  void 插入(std::uint32_t 编号) {
+    节点 &项 = 节点列表[编号];
+    std::uint64_t 距离 = 项.到期 - 当前刻;
+    std::uint32_t 层 = 0;
+    while (层 + 1 < 层数 && 距离 >= (1ull << (每层位数 * (层 + 1))))
+      ++层;
+    auto 槽 = static_cast<std::uint32_t>((项.到期 >> (每层位数 * 层)) &
+                                         (每层槽数 - 1));
+    项.槽号 = 层 * 每层槽数 + 槽;
+    auto &列表 = 槽列表[项.槽号];
+    项.槽内位置 = static_cast<std::uint32_t>(列表.size());
+    列表.push_back(编号);
+  }
+
+  void 摘除(std::uint32_t 编号) {
+    节点 &项 = 节点列表[编号];
+    auto &列表 = 槽列表[项.槽号];
+    std::uint32_t 末尾 = 列表.back();
+    列表[项.槽内位置] = 末尾;
+    节点列表[末尾].槽内位置 = 项.槽内位置;
+    列表.pop_back();
+    项.槽号 = 无;
+  }
+
+  // 降级的节点一定落到更低的层, 不会写回正在遍历的槽
+  void 级联(std::uint32_t 层, std::uint64_t 槽) {
+    级联缓冲.clear();
+    级联缓冲.swap(槽列表[层 * 每层槽数 + 槽]);
+    for (std::uint32_t 编号 : 级联缓冲)
+      插入(编号);
+    统计.级联移动数 += 级联缓冲.size();
+  }
+};
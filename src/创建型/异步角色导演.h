@@ -0,0 +1,125 @@
+// 异步角色导演.h
+// 按建造者声明的步骤依赖, 把互不依赖的构建步骤并行提交到任务池,
+// 返回最终角色的 future; 适合步骤中有加载资源、查询数据库等等待的场景
+#pragma once
+
+#include "任务池.h"
+#include "建造者示例.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+// 依赖只能指向编号更小的步骤, 这样依赖图必然无环, 同步顺序也仍然有效
+template <typename T> constexpr bool 步骤依赖有效() {
+  for (std::size_t 步骤 = 0; 步骤 < 构建步骤数; ++步骤)
+    if (T::步骤依赖[步骤] >> 步骤)
+      return false;
+  return true;
+}
+
+template <角色建造者概念 T>
+  requires requires { T::步骤依赖; }
+class 异步构建过程 : public std::enable_shared_from_this<异步构建过程<T>> {
+public:
+  static_assert(步骤依赖有效<T>(), "构建步骤只能依赖编号更小的步骤");
+
+  template <typename... 参数类型>
+  explicit 异步构建过程(任务池 &池, 参数类型 &&...参数)
+      : 池(池), 建造者(std::forward<参数类型>(参数)...) {
+    for (std::size_t 步骤 = 0; 步骤 < 构建步骤数; ++步骤)
+      剩余依赖[步骤].store(std::popcount(T::步骤依赖[步骤]),
+                           std::memory_order_relaxed);
+  }
+
+  std::future<游戏角色> 启动() {
+    auto 结果 = 承诺.get_future();
+    for (std::size_t 步骤 = 0; 步骤 < 构建步骤数; ++步骤)
+      if (T::步骤依赖[步骤] == 0)
+        提交(步骤);
+    return 结果;
+  }
+
+private:
+  任务池 &池;
+  T 建造者;
+  std::array<std::atomic<int>, 构建步骤数> 剩余依赖;
+  std::atomic<std::size_t> 未完成步骤{构建步骤数};
+  std::promise<游戏角色> 承诺;
+  std::once_flag 记录错误;
+  std::exception_ptr 错误;
+  std::atomic<bool> 已失败{false};
+
+  void 提交(std::size_t 步骤) {
+    池.提交([自身 = this->shared_from_this(), 步骤] { 自身->执行(步骤); });
+  }
+
+  // 某步失败后, 后续步骤不再执行, 但仍按依赖关系走完, 最终把异常交给 future
+  void 执行(std::size_t 步骤) {
+    if (!已失败.load(std::memory_order_acquire)) {
+      try {
+        调用(static_cast<构建步骤>(步骤));
+      } catch (...) {
+        std::call_once(记录错误, [&] { 错误 = std::current_exception(); });
+        已失败.store(true, std::memory_order_release);
+      }
+    }
+    for (std::size_t 后继 = 步骤 + 1; 后继 < 构建步骤数; ++后继)
+      if ((T::步骤依赖[后继] >> 步骤) & 1)
+        if (剩余依赖[后继].fetch_sub(1, std::memory_order_acq_rel) == 1)
+          提交(后继);
+    if (未完成步骤.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      完成();
+  }
+
+  void 调用(构建步骤 步骤) {
+    switch (步骤) {
+    case 构建步骤::职业:
+      return 建造者.构建职业();
+    case 构建步骤::武器:
+      return 建造者.构建武器();
+    case 构建步骤::护甲:
+      return 建造者.构建护甲();
+    case 构建步骤::等级:
+      return 建造者.构建等级();
+    case 构建步骤::技能:
+      return 建造者.构建技能();
+    }
+  }
+
+  void 完成() {
+    if (已失败.load(std::memory_order_acquire)) {
+      承诺.set_exception(错误);
+      return;
+    }
+    try {
+      承诺.set_value(std::move(*建造者.获取角色()));
+    } catch (...) {
+      承诺.set_exception(std::current_exception());
+    }
+  }
+};
+
+// 异步导演: 各步骤分别写入角色的不同成员, 并行执行不会互相干扰
+class 异步角色导演 {
+public:
+  explicit 异步角色导演(任务池 &池) : 池(&池) {}
+
+  // 在内部构造建造者 T(参数...), 立即开始构建
+  template <角色建造者概念 T, typename... 参数类型>
+  std::future<游戏角色> 构建角色(参数类型 &&...参数) {
+    return std::make_shared<异步构建过程<T>>(
+               *池, std::forward<参数类型>(参数)...)
+        ->启动();
+  }
+
+private:
+  任务池 *池;
+};
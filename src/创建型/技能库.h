@@ -0,0 +1,115 @@
+// 技能库.h
+// 技能名称 <-> 紧凑编号; 每个角色的技能存成定长位集, 按位运算判断拥有关系
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using 技能编号 = std::uint16_t;
+
+// 定长技能位集: 第 n 位表示拥有编号为 n 的技能
+struct 技能集 {
+  static constexpr std::size_t 位数 = 256;
+  static constexpr std::size_t 字数 = 位数 / 64;
+
+  std::array<std::uint64_t, 字数> 字{};
+
+  constexpr void 加入(技能编号 技能) {
+    字[技能 / 64] |= std::uint64_t{1} << (技能 % 64);
+  }
+  constexpr bool 包含(技能编号 技能) const {
+    return (字[技能 / 64] >> (技能 % 64)) & 1;
+  }
+  constexpr bool 包含全部(const 技能集 &其他) const {
+    for (std::size_t i = 0; i < 字数; ++i)
+      if ((字[i] & 其他.字[i]) != 其他.字[i])
+        return false;
+    return true;
+  }
+  constexpr bool 包含任一(const 技能集 &其他) const {
+    for (std::size_t i = 0; i < 字数; ++i)
+      if (字[i] & 其他.字[i])
+        return true;
+    return false;
+  }
+  constexpr std::size_t 数量() const {
+    std::size_t 总数 = 0;
+    for (auto 值 : 字)
+      总数 += std::popcount(值);
+    return 总数;
+  }
+
+  // 按编号从小到大访问每个技能
+  template <typename 函数类型> constexpr void 遍历(函数类型 &&函数) const {
+    for (std::size_t i = 0; i < 字数; ++i)
+      for (auto 值 = 字[i]; 值 != 0; 值 &= 值 - 1)
+        函数(static_cast<技能编号>(i * 64 + std::countr_zero(值)));
+  }
+
+  friend constexpr bool operator==(const 技能集 &, const 技能集 &) = default;
+};
+
+// 全局技能库: 按登记顺序分配从 0 开始的稠密编号
+// 登记与查找可在任意线程调用; 名称一经登记不再移动, 可以无锁读取
+class 技能库 {
+public:
+  static 技能库 &全局() {
+    static 技能库 实例;
+    return 实例;
+  }
+
+  技能编号 登记(std::string_view 名称) {
+    std::lock_guard 守卫(锁);
+    if (auto 位置 = 索引.find(名称); 位置 != 索引.end())
+      return 位置->second;
+    if (数量 == 技能集::位数)
+      throw std::length_error("技能数量超出技能集容量");
+    auto 新编号 = static_cast<技能编号>(数量++);
+    名称列表[新编号] = 名称;
+    索引.emplace(名称列表[新编号], 新编号);
+    return 新编号;
+  }
+
+  // 未登记时返回 false, 不会新增技能
+  bool 查找(std::string_view 名称, 技能编号 &结果) const {
+    std::lock_guard 守卫(锁);
+    auto 位置 = 索引.find(名称);
+    if (位置 == 索引.end())
+      return false;
+    结果 = 位置->second;
+    return true;
+  }
+
+  // 编号必须来自 登记 或 查找
+  std::string_view 名称(技能编号 技能) const { return 名称列表[技能]; }
+
+  // 由若干名称组成查询条件; 任一名称未登记时返回 false
+  template <typename... 名称类型>
+  bool 组成(技能集 &结果, const 名称类型 &...名称) const {
+    技能编号 技能;
+    return ((查找(名称, 技能) && (结果.加入(技能), true)) && ...);
+  }
+
+private:
+  技能库() = default;
+
+  struct 透明哈希 {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view 键) const {
+      return std::hash<std::string_view>{}(键);
+    }
+  };
+
+  mutable std::mutex 锁;
+  std::array<std::string, 技能集::位数> 名称列表;
+  std::size_t 数量 = 0;
+  std::unordered_map<std::string_view, 技能编号, 透明哈希, std::equal_to<>>
+      索引;
+};
@@ -0,0 +1,362 @@
+// 武器注册表.h
+// 数据驱动的武器工厂: 从定义文件批量注册武器, 运行时按名称生成 子弹枪
+// 子弹类型名 -> 解析函数 使用编译期生成的完美哈希
+// 武器名 -> 枪工厂 使用加载后构建的 "哈希+位移" 完美哈希表
+#pragma once
+
+#include "工厂示例.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <charconv>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 把哈希值与位移种子混合成槽位哈希 (splitmix64 终结器), 不必再次遍历字符串
+constexpr std::uint64_t 位移混合(std::uint64_t 哈希, std::uint64_t 位移) {
+  哈希 += 位移 * 0x9e3779b97f4a7c15ull;
+  哈希 = (哈希 ^ (哈希 >> 30)) * 0xbf58476d1ce4e5b9ull;
+  哈希 = (哈希 ^ (哈希 >> 27)) * 0x94d049bb133111ebull;
+  return 哈希 ^ (哈希 >> 31);
+}
+
+// FNV-1a 再经终结器打散, 使高位同样均匀 (分桶用高位)
+constexpr std::uint64_t 名称哈希(std::string_view 名称) {
+  std::uint64_t 值 = 0xcbf29ce484222325ull;
+  for (char 字符 : 名称) {
+    值 ^= static_cast<unsigned char>(字符);
+    值 *= 0x100000001b3ull;
+  }
+  return 位移混合(值, 0);
+}
+
+// 编译期完美哈希: 穷举种子, 直到所有键落在互不相同的槽位上
+template <std::size_t 键数> class 静态完美哈希 {
+public:
+  static constexpr std::size_t 槽数 = std::bit_ceil(键数 * 2);
+  static constexpr std::size_t 无效 = 键数;
+
+  consteval explicit 静态完美哈希(
+      const std::array<std::string_view, 键数> &键列表)
+      : 键列表(键列表) {
+    while (!尝试种子())
+      ++种子;
+  }
+
+  // 返回键编号, 不存在时返回 std::nullopt
+  constexpr std::optional<std::size_t> 查找(std::string_view 名称) const {
+    std::size_t 编号 = 槽位[位移混合(名称哈希(名称), 种子) & (槽数 - 1)];
+    if (编号 == 无效 || 键列表[编号] != 名称)
+      return std::nullopt;
+    return 编号;
+  }
+
+private:
+  std::array<std::string_view, 键数> 键列表;
+  std::array<std::size_t, 槽数> 槽位{};
+  std::uint64_t 种子 = 0;
+
+  constexpr bool 尝试种子() {
+    槽位.fill(无效);
+    for (std::size_t i = 0; i < 键数; ++i) {
+      auto &槽 = 槽位[位移混合(名称哈希(键列表[i]), 种子) & (槽数 - 1)];
+      if (槽 != 无效)
+        return false;
+      槽 = i;
+    }
+    return true;
+  }
+};
+
+using 枪工厂 = std::move_only_function<std::unique_ptr<枪>()>;
+using 武器参数 = std::span<const std::string_view>;
+
+namespace 武器定义解析 {
+
+inline int 读整数(std::string_view 文本) {
+  int 值 = 0;
+  auto [结尾, 错误] = std::from_chars(文本.data(), 文本.data() + 文本.size(), 值);
+  if (错误 != std::errc{} || 结尾 != 文本.data() + 文本.size())
+    throw std::invalid_argument("不是整数: " + std::string(文本));
+  return 值;
+}
+
+inline void 检查参数个数(武器参数 参数, std::size_t 个数) {
+  if (参数.size() != 个数)
+    throw std::invalid_argument(
+        std::format("需要 {} 个参数, 实际 {} 个", 个数, 参数.size()));
+}
+
+template <typename 子弹类> 枪工厂 无参(武器参数 参数) {
+  检查参数个数(参数, 0);
+  return [] { return std::make_unique<子弹枪<子弹类>>(); };
+}
+
+inline 枪工厂 ak47(武器参数 参数) {
+  检查参数个数(参数, 1);
+  return [攻击力 = 读整数(参数[0])] {
+    return std::make_unique<子弹枪<ak47子弹>>(攻击力);
+  };
+}
+
+inline 枪工厂 元素(武器参数 参数) {
+  检查参数个数(参数, 2);
+  return [元素 = std::string(参数[0]), 伤害 = 读整数(参数[1])] {
+    return std::make_unique<子弹枪<元素子弹>>(元素, 伤害);
+  };
+}
+
+inline 枪工厂 霰弹枪(武器参数 参数) {
+  std::vector<int> 弹丸;
+  for (auto 文本 : 参数)
+    弹丸.push_back(读整数(文本));
+  return [弹丸 = std::move(弹丸)] {
+    return std::make_unique<子弹枪<霰弹>>(弹丸);
+  };
+}
+
+} // namespace 武器定义解析
+
+// 内置子弹类型: 名称 -> 把定义文件中的参数解析成枪工厂
+struct 子弹类型描述 {
+  std::string_view 名称;
+  枪工厂 (*解析)(武器参数 参数);
+};
+
+inline constexpr std::array 内置子弹类型{
+    子弹类型描述{"实体子弹", 武器定义解析::无参<实体子弹>},
+    子弹类型描述{"能量子弹", 武器定义解析::无参<能量子弹>},
+    子弹类型描述{"ak47子弹", 武器定义解析::ak47},
+    子弹类型描述{"元素子弹", 武器定义解析::元素},
+    子弹类型描述{"霰弹", 武器定义解析::霰弹枪},
+};
+
+inline constexpr 静态完美哈希<内置子弹类型.size()> 内置子弹类型哈希{[] {
+  std::array<std::string_view, 内置子弹类型.size()> 名称列表;
+  for (std::size_t i = 0; i < 名称列表.size(); ++i)
+    名称列表[i] = 内置子弹类型[i].名称;
+  return 名称列表;
+}()};
+
+constexpr const 子弹类型描述 *查找子弹类型(std::string_view 名称) {
+  auto 编号 = 内置子弹类型哈希.查找(名称);
+  return 编号 ? &内置子弹类型[*编号] : nullptr;
+}
+
+class 武器注册表 {
+public:
+  static constexpr std::uint32_t 空槽 = UINT32_MAX;
+  static constexpr std::size_t 最大负载倍数 = 64; // 槽数最多放宽到键数的这么多倍
+
+  // 注册一个武器; 注册完毕后需调用 构建索引() 才能查找
+  void 注册(std::string 名称, 枪工厂 工厂) {
+    条目列表.push_back({std::move(名称), std::move(工厂), 0});
+    索引有效 = false;
+  }
+
+  // 按 "<名称> <子弹类型> [参数...]" 的格式注册一行定义
+  void 注册定义(std::string_view 名称, std::string_view 子弹类型,
+                武器参数 参数) {
+    注册(std::string(名称), 解析定义(子弹类型, 参数));
+  }
+
+  // 从流中批量加载武器定义, 每行一个, # 开头为注释; 返回加载的条数
+  // 先解析到暂存列表, 全部成功才并入注册表; 出错时注册表保持原样
+  std::size_t 加载定义(std::istream &输入) {
+    std::size_t 行号 = 0;
+    std::vector<条目> 暂存;
+    std::string 行;
+    std::vector<std::string_view> 字段;
+    while (std::getline(输入, 行)) {
+      ++行号;
+      字段.clear();
+      std::string_view 剩余 = 行;
+      剩余 = 剩余.substr(0, 剩余.find('#'));
+      while (!剩余.empty()) {
+        auto 开始 = 剩余.find_first_not_of(" \t\r");
+        if (开始 == std::string_view::npos)
+          break;
+        剩余.remove_prefix(开始);
+        auto 结束 = std::min(剩余.find_first_of(" \t\r"), 剩余.size());
+        字段.push_back(剩余.substr(0, 结束));
+        剩余.remove_prefix(结束);
+      }
+      if (字段.empty())
+        continue;
+      if (字段.size() < 2)
+        throw std::runtime_error(
+            std::format("武器定义第 {} 行: 缺少子弹类型", 行号));
+      try {
+        暂存.push_back({std::string(字段[0]),
+                        解析定义(字段[1], 武器参数(字段).subspan(2)), 0});
+      } catch (const std::invalid_argument &错误) {
+        throw std::runtime_error(
+            std::format("武器定义第 {} 行: {}", 行号, 错误.what()));
+      }
+    }
+
+    const std::size_t 原条数 = 条目列表.size();
+    条目列表.insert(条目列表.end(), std::make_move_iterator(暂存.begin()),
+                    std::make_move_iterator(暂存.end()));
+    try {
+      构建索引();
+    } catch (...) {
+      // 与已有武器重名: 撤回本次加载的条目, 恢复原来的索引
+      条目列表.erase(条目列表.begin() + 原条数, 条目列表.end());
+      构建索引();
+      throw;
+    }
+    return 暂存.size();
+  }
+
+  std::size_t 加载定义文件(const std::string &文件路径) {
+    std::ifstream 文件(文件路径);
+    if (!文件)
+      throw std::runtime_error("无法打开武器定义文件: " + 文件路径);
+    return 加载定义(文件);
+  }
+
+  // 构建 "哈希+位移" 完美哈希: 键按名称哈希的高位分桶, 再为每个桶
+  // 寻找一个位移种子, 使桶内所有键落在空闲且互不相同的槽位上
+  // 重名或两个名称的 64 位哈希相同时抛出 std::invalid_argument
+  void 构建索引() {
+    const std::size_t 键数 = 条目列表.size();
+    std::size_t 槽数 = std::bit_ceil(键数 + 键数 / 4 + 1);
+    std::size_t 桶数 = std::bit_ceil(键数 / 4 + 1);
+
+    for (auto &条 : 条目列表)
+      条.哈希 = 名称哈希(条.名称);
+    检查哈希唯一();
+
+    std::vector<std::vector<std::uint32_t>> 桶(桶数);
+    for (std::uint32_t i = 0; i < 键数; ++i)
+      桶[(条目列表[i].哈希 >> 32) & (桶数 - 1)].push_back(i);
+
+    std::vector<std::size_t> 桶顺序(桶数);
+    for (std::size_t i = 0; i < 桶数; ++i)
+      桶顺序[i] = i;
+    std::ranges::stable_sort(桶顺序, std::ranges::greater{},
+                             [&](std::size_t i) { return 桶[i].size(); });
+
+    // 哈希互不相同时位移搜索几乎总能一次成功; 失败则放宽负载再试, 有上限
+    for (;;) {
+      位移.assign(桶数, 0);
+      槽位.assign(槽数, 空槽);
+      if (尝试放置(桶, 桶顺序))
+        break;
+      if (槽数 >= 最大负载倍数 * std::bit_ceil(键数 + 1))
+        throw std::runtime_error("武器注册表: 无法构建完美哈希索引");
+      槽数 *= 2;
+    }
+    索引有效 = true;
+  }
+
+  // 返回武器编号, 未注册时返回 std::nullopt
+  std::optional<std::size_t> 查找(std::string_view 名称) const {
+    assert(索引有效 && "注册后需先调用 构建索引()");
+    if (槽位.empty())
+      return std::nullopt;
+    auto 哈希 = 名称哈希(名称);
+    auto 桶 = (哈希 >> 32) & (位移.size() - 1);
+    auto 编号 = 槽位[位移混合(哈希, 位移[桶]) & (槽位.size() - 1)];
+    if (编号 == 空槽 || 条目列表[编号].哈希 != 哈希 ||
+        条目列表[编号].名称 != 名称)
+      return std::nullopt;
+    return 编号;
+  }
+
+  // 热路径上先用 查找 取得编号, 之后按编号生成可省去哈希
+  std::unique_ptr<枪> 生成(std::size_t 编号) { return 条目列表[编号].工厂(); }
+
+  std::unique_ptr<枪> 生成(std::string_view 名称) {
+    auto 编号 = 查找(名称);
+    if (!编号)
+      throw std::out_of_range("未注册的武器: " + std::string(名称));
+    return 生成(*编号);
+  }
+
+  std::size_t 大小() const { return 条目列表.size(); }
+
+private:
+  struct 条目 {
+    std::string 名称;
+    枪工厂 工厂;
+    std::uint64_t 哈希 = 0; // 构建索引时缓存的名称哈希
+  };
+
+  std::vector<条目> 条目列表;
+  std::vector<std::uint32_t> 位移; // 每个桶的位移种子
+  std::vector<std::uint32_t> 槽位; // 槽位 -> 条目编号
+  bool 索引有效 = true;
+
+  static 枪工厂 解析定义(std::string_view 子弹类型, 武器参数 参数) {
+    const 子弹类型描述 *描述 = 查找子弹类型(子弹类型);
+    if (!描述)
+      throw std::invalid_argument("未知的子弹类型: " + std::string(子弹类型));
+    return 描述->解析(参数);
+  }
+
+  bool 尝试放置(const std::vector<std::vector<std::uint32_t>> &桶,
+                const std::vector<std::size_t> &桶顺序) {
+    constexpr std::uint32_t 最大位移 = 1u << 16;
+    const std::size_t 掩码 = 槽位.size() - 1;
+    std::vector<std::size_t> 候选;
+    for (std::size_t 桶号 : 桶顺序) {
+      const auto &键 = 桶[桶号];
+      if (键.empty())
+        break; // 已按大小降序, 后面都是空桶
+      std::uint32_t 种子 = 1;
+      for (; 种子 < 最大位移; ++种子) {
+        候选.clear();
+        bool 冲突 = false;
+        for (std::uint32_t 编号 : 键) {
+          std::size_t 槽 = 位移混合(条目列表[编号].哈希, 种子) & 掩码;
+          if (槽位[槽] != 空槽 || std::ranges::find(候选, 槽) != 候选.end()) {
+            冲突 = true;
+            break;
+          }
+          候选.push_back(槽);
+        }
+        if (!冲突)
+          break;
+      }
+      if (种子 == 最大位移)
+        return false;
+      位移[桶号] = 种子;
+      for (std::size_t i = 0; i < 键.size(); ++i)
+        槽位[候选[i]] = 键[i];
+    }
+    return true;
+  }
+
+  // 哈希相同的两个键在任何位移下都落在同一槽位, 位移搜索不可能成功,
+  // 所以在放置前按哈希排序, 检查相邻的键; 调用前 哈希 须已计算
+  void 检查哈希唯一() const {
+    std::vector<std::uint32_t> 顺序(条目列表.size());
+    for (std::uint32_t i = 0; i < 顺序.size(); ++i)
+      顺序[i] = i;
+    std::ranges::sort(顺序, {}, [&](std::uint32_t i) { return 条目列表[i].哈希; });
+    for (std::size_t i = 1; i < 顺序.size(); ++i) {
+      const 条目 &前 = 条目列表[顺序[i - 1]];
+      const 条目 &后 = 条目列表[顺序[i]];
+      if (前.哈希 != 后.哈希)
+        continue;
+      if (前.名称 == 后.名称)
+        throw std::invalid_argument("重复注册的武器: " + 前.名称);
+      throw std::invalid_argument("武器名称哈希冲突: " + 前.名称 + " 与 " +
+                                  后.名称);
+    }
+  }
+};
@@ -0,0 +1,184 @@
+// 线程子弹池.h
+// 多线程池化工厂: 每个线程从自己的竞技场分配子弹, 互不争抢全局分配器
+// 在其他线程销毁的子弹经无锁归还栈送回所属竞技场, 由所属线程批量回收
+#pragma once
+
+#include "工厂示例.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+template <std::derived_from<子弹> 子弹类> class 子弹竞技场;
+
+template <std::derived_from<子弹> 子弹类> struct 竞技场回收器 {
+  子弹竞技场<子弹类> *竞技场 = nullptr;
+
+  void operator()(子弹类 *子弹实例) const noexcept {
+    子弹实例->子弹类::~子弹类();
+    竞技场->还槽(子弹实例);
+  }
+};
+
+// 句柄可以在任意线程销毁
+template <std::derived_from<子弹> 子弹类>
+using 线程子弹句柄 = std::unique_ptr<子弹类, 竞技场回收器<子弹类>>;
+
+// 单个线程独占的槽位竞技场: 分配和本线程归还都不需要同步
+template <std::derived_from<子弹> 子弹类> class 子弹竞技场 {
+  union 槽位 {
+    槽位 *下一个;
+    alignas(子弹类) std::byte 存储[sizeof(子弹类)];
+  };
+
+  // 以下成员只由所属线程访问
+  std::vector<std::unique_ptr<槽位[]>> 块列表;
+  槽位 *空闲链表 = nullptr;
+  std::size_t 每块槽数;
+  std::thread::id 所属线程;
+
+  // 其他线程归还的槽位: 多生产者压栈, 所属线程一次整体取走, 不存在 ABA
+  alignas(64) std::atomic<槽位 *> 归还栈{nullptr};
+  std::atomic<std::size_t> 远程归还次数{0};
+
+  void 扩容() {
+    auto 新块 = std::make_unique_for_overwrite<槽位[]>(每块槽数);
+    for (std::size_t i = 每块槽数; i-- > 0;) {
+      新块[i].下一个 = 空闲链表;
+      空闲链表 = &新块[i];
+    }
+    块列表.push_back(std::move(新块));
+  }
+
+public:
+  子弹竞技场(std::thread::id 所属线程, std::size_t 每块槽数)
+      : 每块槽数(每块槽数 > 0 ? 每块槽数 : 1), 所属线程(所属线程) {}
+
+  子弹竞技场(const 子弹竞技场 &) = delete;
+  子弹竞技场 &operator=(const 子弹竞技场 &) = delete;
+
+  // 只能由所属线程调用; 本地空闲链表用尽时先收回其他线程归还的槽位
+  void *取槽() {
+    if (!空闲链表)
+      空闲链表 = 归还栈.exchange(nullptr, std::memory_order_acquire);
+    if (!空闲链表)
+      扩容();
+    槽位 *槽 = 空闲链表;
+    空闲链表 = 槽->下一个;
+    return 槽->存储;
+  }
+
+  // 任意线程均可调用
+  void 还槽(void *地址) noexcept {
+    auto *槽 = reinterpret_cast<槽位 *>(地址);
+    if (std::this_thread::get_id() == 所属线程) {
+      槽->下一个 = 空闲链表;
+      空闲链表 = 槽;
+      return;
+    }
+    槽->下一个 = 归还栈.load(std::memory_order_relaxed);
+    while (!归还栈.compare_exchange_weak(槽->下一个, 槽,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+    }
+    远程归还次数.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  std::size_t 远程归还() const {
+    return 远程归还次数.load(std::memory_order_relaxed);
+  }
+};
+
+inline std::atomic<std::uint64_t> 线程子弹工厂计数{0};
+
+// 线程感知的子弹工厂: 为每个调用线程惰性创建一个竞技场
+// 竞技场归工厂所有, 工厂必须比它发出的所有句柄活得更久
+template <std::derived_from<子弹> 子弹类> class 线程子弹工厂 {
+  struct 缓存项 {
+    std::uint64_t 工厂编号 = 0;
+    子弹竞技场<子弹类> *竞技场 = nullptr;
+  };
+  // 每个线程记住最近使用的几个工厂的竞技场, 命中时无需加锁
+  static constexpr std::size_t 缓存容量 = 4;
+  static inline thread_local 缓存项 线程缓存[缓存容量];
+  static inline thread_local std::size_t 下次替换 = 0;
+
+  const std::uint64_t 编号 = ++线程子弹工厂计数; // 不复用, 避免缓存误命中
+  std::size_t 每块槽数;
+  std::mutex 锁;
+  std::vector<std::unique_ptr<子弹竞技场<子弹类>>> 竞技场列表;
+  std::vector<std::thread::id> 竞技场线程;
+
+  子弹竞技场<子弹类> &查找或创建竞技场() {
+    auto 线程 = std::this_thread::get_id();
+    std::lock_guard 守卫(锁);
+    // 线程号可能被新线程复用, 此时新线程直接接管旧竞技场
+    for (std::size_t i = 0; i < 竞技场线程.size(); ++i)
+      if (竞技场线程[i] == 线程)
+        return *竞技场列表[i];
+    竞技场列表.push_back(
+        std::make_unique<子弹竞技场<子弹类>>(线程, 每块槽数));
+    竞技场线程.push_back(线程);
+    return *竞技场列表.back();
+  }
+
+public:
+  explicit 线程子弹工厂(std::size_t 每块槽数 = 256) : 每块槽数(每块槽数) {}
+
+  线程子弹工厂(const 线程子弹工厂 &) = delete;
+  线程子弹工厂 &operator=(const 线程子弹工厂 &) = delete;
+
+  子弹竞技场<子弹类> &本线程竞技场() {
+    for (auto &项 : 线程缓存)
+      if (项.工厂编号 == 编号)
+        return *项.竞技场;
+    auto &竞技场 = 查找或创建竞技场();
+    线程缓存[下次替换++ % 缓存容量] = {编号, &竞技场};
+    return 竞技场;
+  }
+
+  template <typename 构造函数类型>
+  线程子弹句柄<子弹类> 就地创建(构造函数类型 &&构造) {
+    auto &竞技场 = 本线程竞技场();
+    void *槽 = 竞技场.取槽();
+    try {
+      子弹类 *子弹实例 = std::forward<构造函数类型>(构造)(槽);
+      return 线程子弹句柄<子弹类>(子弹实例, 竞技场回收器<子弹类>{&竞技场});
+    } catch (...) {
+      竞技场.还槽(槽);
+      throw;
+    }
+  }
+
+  template <typename... 参数类型>
+    requires std::constructible_from<子弹类, 参数类型...>
+  线程子弹句柄<子弹类> 创建(参数类型 &&...参数) {
+    return 就地创建([&](void *槽) {
+      return ::new (槽) 子弹类(std::forward<参数类型>(参数)...);
+    });
+  }
+
+  std::size_t 竞技场数量() {
+    std::lock_guard 守卫(锁);
+    return 竞技场列表.size();
+  }
+};
+
+// 每个工作线程持有自己的枪, 多把枪共享同一个线程子弹工厂
+template <std::derived_from<子弹> 子弹类> class 线程池化子弹枪 {
+  子弹枪<子弹类> 枪实例;
+  std::shared_ptr<线程子弹工厂<子弹类>> 工厂;
+
+public:
+  线程池化子弹枪(子弹枪<子弹类> 枪实例,
+                 std::shared_ptr<线程子弹工厂<子弹类>> 共享工厂)
+      : 枪实例(std::move(枪实例)), 工厂(std::move(共享工厂)) {}
+
+  线程子弹句柄<子弹类> 射击() {
+    return 工厂->就地创建([this](void *槽) { return 枪实例.就地射击(槽); });
+  }
+};
@@ -0,0 +1,407 @@
+// 角色原型库.h
+// 数据驱动的角色原型: 从文本文件加载, 并在源文件旁写一份二进制缓存
+// 之后的启动只要源文件哈希没变, 就直接映射缓存, 不再解析文本
+#pragma once
+
+#include "只读文件映射.h"
+#include "建造者示例.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// 缓存文件格式 (本机字节序):
+//   文件头 | 原型条目[原型数] (按名称排序) | 字符串引用[技能引用数] | 字符串区
+namespace 原型缓存格式 {
+
+inline constexpr char 魔数[8] = {'J', 'S', 'Y', 'X', 'H', 'C', 0, 1};
+inline constexpr std::uint32_t 版本 = 1;
+
+struct 文件头 {
+  char 魔数[8];
+  std::uint32_t 版本;
+  std::uint32_t 原型数;
+  std::uint64_t 源哈希;   // 生成缓存时源文件内容的哈希
+  std::uint64_t 载荷哈希; // 文件头之后全部字节的哈希
+  std::uint32_t 技能引用数;
+  std::uint32_t 字符串字节;
+};
+
+struct 字符串引用 {
+  std::uint32_t 偏移; // 相对字符串区起点
+  std::uint32_t 长度;
+};
+
+struct 原型条目 {
+  字符串引用 名称, 职业, 武器, 护甲;
+  std::int32_t 等级;
+  std::uint32_t 技能起点; // 在技能引用区中的下标
+  std::uint32_t 技能数;
+  std::uint32_t 保留;
+};
+
+// FNV-1a 的按字变体: 每次吸收 8 字节, 尾部逐字节; 热启动要对源文件和缓存各哈希一遍
+inline std::uint64_t 内容哈希(std::span<const std::byte> 内容) {
+  constexpr std::uint64_t 质数 = 0x100000001b3ull;
+  std::uint64_t 哈希 = 0xcbf29ce484222325ull ^ 内容.size();
+  std::size_t i = 0;
+  for (; i + 8 <= 内容.size(); i += 8) {
+    std::uint64_t 字;
+    std::memcpy(&字, 内容.data() + i, sizeof 字);
+    哈希 = (哈希 ^ 字) * 质数;
+    哈希 ^= 哈希 >> 32;
+  }
+  for (; i < 内容.size(); ++i)
+    哈希 = (哈希 ^ static_cast<std::uint8_t>(内容[i])) * 质数;
+  return 哈希;
+}
+
+} // namespace 原型缓存格式
+
+// 缓存中一个原型的只读视图, 字符串直接指向缓存内存
+class 原型视图 {
+public:
+  std::string_view 名称, 职业, 武器, 护甲;
+  int 等级;
+
+  std::size_t 技能数() const { return 技能个数; }
+  std::string_view 技能(std::size_t 下标) const {
+    原型缓存格式::字符串引用 引用;
+    std::memcpy(&引用, 技能引用 + 下标 * sizeof 引用, sizeof 引用);
+    return 取字符串(引用, 字符串区);
+  }
+
+private:
+  friend class 角色原型库;
+  原型视图(const 原型缓存格式::原型条目 &条目, const std::byte *技能引用,
+           const char *字符串区)
+      : 名称(取字符串(条目.名称, 字符串区)), 职业(取字符串(条目.职业, 字符串区)),
+        武器(取字符串(条目.武器, 字符串区)), 护甲(取字符串(条目.护甲, 字符串区)),
+        等级(条目.等级), 技能引用(技能引用), 技能个数(条目.技能数),
+        字符串区(字符串区) {}
+
+  static std::string_view 取字符串(原型缓存格式::字符串引用 引用,
+                                   const char *字符串区) {
+    return {字符串区 + 引用.偏移, 引用.长度};
+  }
+
+  const std::byte *技能引用; // 本原型的第一个技能引用
+  std::size_t 技能个数;
+  const char *字符串区;
+};
+
+// 数据建造者: 按原型视图逐步构建角色, 可交给 角色导演 使用
+class 数据建造者 : public 角色建造者基类<数据建造者> {
+  friend class 角色建造者基类<数据建造者>;
+
+public:
+  explicit 数据建造者(const 原型视图 &原型) : 原型(原型) {}
+
+private:
+  原型视图 原型;
+
+  void 构建职业实现() { 角色->设置职业(原型.职业); }
+  void 构建武器实现() { 角色->设置武器(原型.武器); }
+  void 构建护甲实现() { 角色->设置护甲(原型.护甲); }
+  void 构建等级实现() { 角色->设置等级(原型.等级); }
+  void 构建技能实现() {
+    for (std::size_t i = 0; i < 原型.技能数(); ++i)
+      角色->添加技能(原型.技能(i));
+  }
+};
+
+class 角色原型库 {
+public:
+  // 优先使用 <源文件>.缓存; 缓存缺失、损坏或源文件已修改时重新解析并重写缓存
+  // 缓存写入失败 (例如目录只读) 不影响加载结果
+  static 角色原型库 加载(const std::filesystem::path &源文件) {
+    auto 源 = 只读文件映射::打开(源文件);
+    if (!源)
+      throw std::runtime_error("无法打开角色原型文件: " + 源文件.string());
+    const auto 源哈希 = 原型缓存格式::内容哈希(源->内容());
+    const auto 缓存文件 = 缓存路径(源文件);
+
+    if (auto 缓存 = 只读文件映射::打开(缓存文件)) {
+      角色原型库 库(std::move(*缓存));
+      if (库.校验(源哈希))
+        return 库;
+    }
+
+    角色原型库 库(序列化(解析文本(文本视图(源->内容())), 源哈希));
+    库.写入缓存(缓存文件);
+    return 库;
+  }
+
+  // 只解析文本, 不读写缓存
+  static 角色原型库 解析(const std::filesystem::path &源文件) {
+    auto 源 = 只读文件映射::打开(源文件);
+    if (!源)
+      throw std::runtime_error("无法打开角色原型文件: " + 源文件.string());
+    return 角色原型库(序列化(解析文本(文本视图(源->内容())),
+                             原型缓存格式::内容哈希(源->内容())));
+  }
+
+  static std::filesystem::path 缓存路径(const std::filesystem::path &源文件) {
+    auto 路径 = 源文件;
+    路径 += ".缓存";
+    return 路径;
+  }
+
+  bool 来自缓存() const {
+    return std::holds_alternative<只读文件映射>(存储);
+  }
+  std::size_t 大小() const { return 头.原型数; }
+
+  原型视图 原型(std::size_t 下标) const {
+    auto 条目 = 读取<原型缓存格式::原型条目>(条目偏移(下标));
+    return 原型视图(条目,
+                    内容.data() + 技能引用偏移() +
+                        std::size_t{条目.技能起点} *
+                            sizeof(原型缓存格式::字符串引用),
+                    字符串区());
+  }
+
+  // 条目按名称排序, 二分查找
+  std::optional<std::size_t> 查找(std::string_view 名称) const {
+    std::size_t 低 = 0, 高 = 大小();
+    while (低 < 高) {
+      std::size_t 中 = 低 + (高 - 低) / 2;
+      auto 当前 = 原型(中).名称;
+      if (当前 == 名称)
+        return 中;
+      if (当前 < 名称)
+        低 = 中 + 1;
+      else
+        高 = 中;
+    }
+    return std::nullopt;
+  }
+
+  // 走 角色导演 的构建流程, 数据来自原型
+  std::unique_ptr<游戏角色> 创建(std::size_t 下标) const {
+    数据建造者 建造者(原型(下标));
+    执行构建步骤(建造者);
+    return 建造者.获取角色();
+  }
+
+  std::unique_ptr<游戏角色> 创建(std::string_view 名称) const {
+    auto 下标 = 查找(名称);
+    if (!下标)
+      throw std::out_of_range("未知的角色原型: " + std::string(名称));
+    return 创建(*下标);
+  }
+
+private:
+  using 缓冲 = std::vector<std::byte>;
+
+  // 解析阶段的中间结果
+  struct 文本原型 {
+    std::string_view 名称, 职业, 武器, 护甲;
+    int 等级;
+    std::vector<std::string_view> 技能;
+    std::size_t 行号;
+  };
+
+  std::variant<缓冲, 只读文件映射> 存储;
+  std::span<const std::byte> 内容;
+  原型缓存格式::文件头 头{};
+
+  explicit 角色原型库(缓冲 数据) : 存储(std::move(数据)) {
+    内容 = std::get<缓冲>(存储);
+    std::memcpy(&头, 内容.data(), sizeof 头);
+  }
+  explicit 角色原型库(只读文件映射 映射) : 存储(std::move(映射)) {
+    内容 = std::get<只读文件映射>(存储).内容();
+    if (内容.size() >= sizeof 头)
+      std::memcpy(&头, 内容.data(), sizeof 头);
+  }
+
+  // 缓存是原始字节, 按 memcpy 读取结构, 不依赖对齐与类型双关
+  template <typename 类型> 类型 读取(std::size_t 偏移) const {
+    类型 值;
+    std::memcpy(&值, 内容.data() + 偏移, sizeof 值);
+    return 值;
+  }
+
+  static std::size_t 条目偏移(std::size_t 下标) {
+    return sizeof(原型缓存格式::文件头) +
+           下标 * sizeof(原型缓存格式::原型条目);
+  }
+  std::size_t 技能引用偏移() const { return 条目偏移(头.原型数); }
+  std::size_t 字符串区偏移() const {
+    return 技能引用偏移() +
+           std::size_t{头.技能引用数} * sizeof(原型缓存格式::字符串引用);
+  }
+
+  const char *字符串区() const {
+    return reinterpret_cast<const char *>(内容.data() + 字符串区偏移());
+  }
+
+  // 校验文件头、载荷哈希与所有偏移; 任何一项不符都视为缓存失效
+  bool 校验(std::uint64_t 源哈希) const {
+    using namespace 原型缓存格式;
+    if (内容.size() < sizeof 头 ||
+        std::memcmp(头.魔数, 魔数, sizeof 魔数) != 0 || 头.版本 != 版本 ||
+        头.源哈希 != 源哈希)
+      return false;
+    if (内容.size() != 字符串区偏移() + 头.字符串字节)
+      return false;
+    if (内容哈希(内容.subspan(sizeof 头)) != 头.载荷哈希)
+      return false;
+    auto 引用有效 = [&](字符串引用 引用) {
+      return 引用.偏移 <= 头.字符串字节 &&
+             引用.长度 <= 头.字符串字节 - 引用.偏移;
+    };
+    for (std::size_t i = 0; i < 头.原型数; ++i) {
+      auto 条目 = 读取<原型条目>(条目偏移(i));
+      if (!引用有效(条目.名称) || !引用有效(条目.职业) ||
+          !引用有效(条目.武器) || !引用有效(条目.护甲) ||
+          条目.技能起点 > 头.技能引用数 ||
+          条目.技能数 > 头.技能引用数 - 条目.技能起点)
+        return false;
+    }
+    for (std::size_t i = 0; i < 头.技能引用数; ++i)
+      if (!引用有效(读取<字符串引用>(技能引用偏移() + i * sizeof(字符串引用))))
+        return false;
+    return true;
+  }
+
+  static std::string_view 文本视图(std::span<const std::byte> 内容) {
+    return {reinterpret_cast<const char *>(内容.data()), 内容.size()};
+  }
+
+  // 每行: <原型名> <职业> <武器> <护甲> <等级> [技能...], # 开头为注释
+  static std::vector<文本原型> 解析文本(std::string_view 文本) {
+    std::vector<文本原型> 结果;
+    std::vector<std::string_view> 字段;
+    std::size_t 行号 = 0;
+    while (!文本.empty()) {
+      ++行号;
+      auto 换行 = std::min(文本.find('\n'), 文本.size());
+      std::string_view 剩余 = 文本.substr(0, 换行);
+      文本.remove_prefix(std::min(换行 + 1, 文本.size()));
+      剩余 = 剩余.substr(0, 剩余.find('#'));
+
+      字段.clear();
+      while (!剩余.empty()) {
+        auto 开始 = 剩余.find_first_not_of(" \t\r");
+        if (开始 == std::string_view::npos)
+          break;
+        剩余.remove_prefix(开始);
+        auto 结束 = std::min(剩余.find_first_of(" \t\r"), 剩余.size());
+        字段.push_back(剩余.substr(0, 结束));
+        剩余.remove_prefix(结束);
+      }
+      if (字段.empty())
+        continue;
+      if (字段.size() < 5)
+        throw std::runtime_error(std::format(
+            "角色原型第 {} 行: 需要 原型名 职业 武器 护甲 等级", 行号));
+
+      int 等级 = 0;
+      auto [结尾, 错误] = std::from_chars(
+          字段[4].data(), 字段[4].data() + 字段[4].size(), 等级);
+      if (错误 != std::errc{} || 结尾 != 字段[4].data() + 字段[4].size())
+        throw std::runtime_error(std::format("角色原型第 {} 行: 等级不是整数: {}",
+                                             行号, 字段[4]));
+      结果.push_back({字段[0], 字段[1], 字段[2], 字段[3], 等级,
+                      {字段.begin() + 5, 字段.end()}, 行号});
+    }
+
+    std::ranges::sort(结果, {}, &文本原型::名称);
+    auto 重复 = std::ranges::adjacent_find(结果, {}, &文本原型::名称);
+    if (重复 != 结果.end())
+      throw std::runtime_error(std::format("角色原型第 {} 行: 重复的原型名: {}",
+                                           std::next(重复)->行号, 重复->名称));
+    return 结果;
+  }
+
+  // 生成缓存字节; 相同字符串在字符串区只存一份
+  static 缓冲 序列化(const std::vector<文本原型> &原型列表,
+                     std::uint64_t 源哈希) {
+    using namespace 原型缓存格式;
+    std::string 字符串区;
+    std::unordered_map<std::string_view, 字符串引用> 已存;
+    auto 存入 = [&](std::string_view 文本) {
+      if (auto 位置 = 已存.find(文本); 位置 != 已存.end())
+        return 位置->second;
+      字符串引用 引用{static_cast<std::uint32_t>(字符串区.size()),
+                      static_cast<std::uint32_t>(文本.size())};
+      字符串区 += 文本;
+      已存.emplace(文本, 引用);
+      return 引用;
+    };
+
+    std::vector<原型条目> 条目列表;
+    std::vector<字符串引用> 技能引用;
+    条目列表.reserve(原型列表.size());
+    for (const auto &原型 : 原型列表) {
+      原型条目 条目{存入(原型.名称), 存入(原型.职业), 存入(原型.武器),
+                    存入(原型.护甲), 原型.等级,
+                    static_cast<std::uint32_t>(技能引用.size()),
+                    static_cast<std::uint32_t>(原型.技能.size()), 0};
+      for (auto 技能 : 原型.技能)
+        技能引用.push_back(存入(技能));
+      条目列表.push_back(条目);
+    }
+
+    文件头 头{};
+    std::memcpy(头.魔数, 魔数, sizeof 魔数);
+    头.版本 = 版本;
+    头.原型数 = static_cast<std::uint32_t>(条目列表.size());
+    头.源哈希 = 源哈希;
+    头.技能引用数 = static_cast<std::uint32_t>(技能引用.size());
+    头.字符串字节 = static_cast<std::uint32_t>(字符串区.size());
+
+    缓冲 数据(sizeof 头 + 条目列表.size() * sizeof(原型条目) +
+              技能引用.size() * sizeof(字符串引用) + 字符串区.size());
+    std::byte *游标 = 数据.data() + sizeof 头;
+    auto 追加 = [&](const void *来源, std::size_t 字节) {
+      if (字节 > 0)
+        std::memcpy(游标, 来源, 字节);
+      游标 += 字节;
+    };
+    追加(条目列表.data(), 条目列表.size() * sizeof(原型条目));
+    追加(技能引用.data(), 技能引用.size() * sizeof(字符串引用));
+    追加(字符串区.data(), 字符串区.size());
+    头.载荷哈希 = 内容哈希(std::span(数据).subspan(sizeof 头));
+    std::memcpy(数据.data(), &头, sizeof 头);
+    return 数据;
+  }
+
+  // 先写临时文件再改名, 其他进程不会读到写了一半的缓存
+  void 写入缓存(const std::filesystem::path &缓存文件) const {
+    auto 临时文件 = 缓存文件;
+    临时文件 += ".tmp";
+    {
+      std::ofstream 输出(临时文件, std::ios::binary | std::ios::trunc);
+      if (!输出)
+        return;
+      输出.write(reinterpret_cast<const char *>(内容.data()),
+                 static_cast<std::streamsize>(内容.size()));
+      if (!输出)
+        return;
+    }
+    std::error_code 错误;
+    std::filesystem::rename(临时文件, 缓存文件, 错误);
+    if (错误)
+      std::filesystem::remove(临时文件, 错误);
+  }
+};
@@ -0,0 +1,251 @@
+// 角色名册.h
+// 列式存储的角色名册: 职业/武器/护甲为小整数编号, 等级为紧凑数组,
+// 技能位集按字拆成若干列; 每批角色的所有列放在一次分配的连续内存里
+#pragma once
+
+#include "建造者示例.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 字符串驻留表: 相同名称只存一份, 以 16 位编号引用
+class 名称表 {
+public:
+  using 编号 = std::uint16_t;
+
+  编号 登记(std::string_view 名称) {
+    if (auto 位置 = 索引.find(名称); 位置 != 索引.end())
+      return 位置->second;
+    if (名称列表.size() > std::numeric_limits<编号>::max())
+      throw std::length_error("名称表已满");
+    auto 新编号 = static_cast<编号>(名称列表.size());
+    名称列表.emplace_back(名称);
+    索引.emplace(名称列表.back(), 新编号);
+    return 新编号;
+  }
+
+  // 未登记时返回 false, 不会新增名称
+  bool 查找(std::string_view 名称, 编号 &结果) const {
+    auto 位置 = 索引.find(名称);
+    if (位置 == 索引.end())
+      return false;
+    结果 = 位置->second;
+    return true;
+  }
+
+  std::string_view 名称(编号 值) const { return 名称列表[值]; }
+  std::size_t 大小() const { return 名称列表.size(); }
+
+private:
+  struct 透明哈希 {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view 键) const {
+      return std::hash<std::string_view>{}(键);
+    }
+  };
+  std::vector<std::string> 名称列表;
+  std::unordered_map<std::string, 编号, 透明哈希, std::equal_to<>> 索引;
+};
+
+// 一批角色: 各列在同一块内存中依次排列
+class 角色批 {
+public:
+  using 编号 = 名称表::编号;
+
+  explicit 角色批(std::size_t 数量) : 数量(数量) {
+    // 按对齐要求从大到小排列各列, 中间不需要填充
+    std::size_t 总字节 = 数量 * (sizeof(技能集) + 4 * sizeof(编号));
+    内存 = std::make_unique_for_overwrite<std::byte[]>(总字节);
+    std::byte *游标 = 内存.get();
+    auto 划分 = [&]<typename 列类型>(列类型 *&列) {
+      列 = reinterpret_cast<列类型 *>(游标);
+      游标 += 数量 * sizeof(列类型);
+    };
+    for (auto &列 : 技能字)
+      划分(列);
+    划分(职业);
+    划分(武器);
+    划分(护甲);
+    划分(等级);
+  }
+
+  std::size_t 大小() const { return 数量; }
+
+  // 只读列视图
+  std::span<const 编号> 职业列() const { return {职业, 数量}; }
+  std::span<const 编号> 武器列() const { return {武器, 数量}; }
+  std::span<const 编号> 护甲列() const { return {护甲, 数量}; }
+  std::span<const std::uint16_t> 等级列() const { return {等级, 数量}; }
+  // 所有角色技能位集的第 字号 个 64 位字
+  std::span<const std::uint64_t> 技能字列(std::size_t 字号) const {
+    return {技能字[字号], 数量};
+  }
+
+  技能集 技能(std::size_t 下标) const {
+    技能集 结果;
+    for (std::size_t i = 0; i < 技能集::字数; ++i)
+      结果.字[i] = 技能字[i][下标];
+    return 结果;
+  }
+
+private:
+  friend class 角色名册;
+
+  std::size_t 数量;
+  std::unique_ptr<std::byte[]> 内存;
+  std::array<std::uint64_t *, 技能集::字数> 技能字; // 按字分列, 查询时顺序扫描
+  编号 *职业;
+  编号 *武器;
+  编号 *护甲;
+  std::uint16_t *等级;
+};
+
+class 角色名册 {
+public:
+  using 编号 = 名称表::编号;
+
+  // 原型登记后的紧凑形式
+  struct 原型记录 {
+    编号 职业, 武器, 护甲;
+    std::uint16_t 等级;
+    技能集 技能;
+  };
+
+  enum class 匹配方式 { 任一, 全部 };
+
+  struct 角色位置 {
+    std::uint32_t 批号;
+    std::uint32_t 下标;
+  };
+
+  // 把任意角色压缩成记录, 结果不缓存
+  原型记录 压缩(const 游戏角色 &角色) {
+    return {名称.登记(角色.获取职业()), 名称.登记(角色.获取武器()),
+            名称.登记(角色.获取护甲()),
+            static_cast<std::uint16_t>(角色.获取等级()), 角色.获取技能()};
+  }
+
+  // 预设原型只登记一次; 只接受 角色原型<T>() 的静态对象,
+  // 它们的地址在整个程序运行期间不变, 可以直接作为缓存键
+  template <角色建造者概念 T> const 原型记录 &登记原型() {
+    const 游戏角色 &原型 = 角色原型<T>();
+    if (auto 位置 = 原型缓存.find(&原型); 位置 != 原型缓存.end())
+      return 位置->second;
+    return 原型缓存.emplace(&原型, 压缩(原型)).first->second;
+  }
+
+  // 追加一批 数量 个同原型角色, 各列整段填充
+  角色批 &追加批(const 原型记录 &记录, std::size_t 数量) {
+    角色批 &批 = *批列表.emplace_back(std::make_unique<角色批>(数量));
+    std::fill_n(批.职业, 数量, 记录.职业);
+    std::fill_n(批.武器, 数量, 记录.武器);
+    std::fill_n(批.护甲, 数量, 记录.护甲);
+    std::fill_n(批.等级, 数量, 记录.等级);
+    for (std::size_t i = 0; i < 技能集::字数; ++i)
+      std::fill_n(批.技能字[i], 数量, 记录.技能.字[i]);
+    角色总数 += 数量;
+    return 批;
+  }
+
+  // 把第 批号 批的第 下标 个角色还原成 游戏角色, 供显示与调试
+  游戏角色 展开(std::size_t 批号, std::size_t 下标) const {
+    const 角色批 &批 = *批列表[批号];
+    游戏角色 角色;
+    角色.设置职业(名称.名称(批.职业列()[下标]));
+    角色.设置武器(名称.名称(批.武器列()[下标]));
+    角色.设置护甲(名称.名称(批.护甲列()[下标]));
+    角色.设置等级(批.等级列()[下标]);
+    批.技能(下标).遍历(
+        [&](技能编号 技能) { 角色.添加技能(技能库::全局().名称(技能)); });
+    return 角色;
+  }
+
+  // 全名册技能查询: 任一 = 至少拥有 条件 中的一个技能, 全部 = 拥有 条件 中的每个技能
+  std::size_t 统计(const 技能集 &条件, 匹配方式 方式) const {
+    std::size_t 总数 = 0;
+    扫描(条件, 方式, [&](std::size_t, std::size_t, const std::uint8_t *命中,
+                         std::size_t 长度) {
+      for (std::size_t i = 0; i < 长度; ++i)
+        总数 += 命中[i];
+    });
+    return 总数;
+  }
+
+  std::size_t 统计拥有(技能编号 技能) const {
+    技能集 条件;
+    条件.加入(技能);
+    return 统计(条件, 匹配方式::全部);
+  }
+
+  // 追加所有命中角色的位置到 输出
+  void 筛选(const 技能集 &条件, 匹配方式 方式,
+            std::vector<角色位置> &输出) const {
+    扫描(条件, 方式, [&](std::size_t 批号, std::size_t 起点,
+                         const std::uint8_t *命中, std::size_t 长度) {
+      for (std::size_t i = 0; i < 长度; ++i)
+        if (命中[i])
+          输出.push_back({static_cast<std::uint32_t>(批号),
+                          static_cast<std::uint32_t>(起点 + i)});
+    });
+  }
+
+  const 名称表 &名称索引() const { return 名称; }
+  std::size_t 批数() const { return 批列表.size(); }
+  const 角色批 &批(std::size_t 批号) const { return *批列表[批号]; }
+  std::size_t 大小() const { return 角色总数; }
+
+private:
+  名称表 名称;
+  std::unordered_map<const 游戏角色 *, 原型记录> 原型缓存; // 键为静态原型的地址
+  std::vector<std::unique_ptr<角色批>> 批列表;
+  std::size_t 角色总数 = 0;
+
+  // 按块扫描: 每块先逐字累积 (条件字 & 技能字) ^ 期望 的差异, 再得出命中标记
+  // 内层循环都是对连续数组的逐元素位运算, 编译器可以向量化
+  template <typename 处理函数类型>
+  void 扫描(const 技能集 &条件, 匹配方式 方式, 处理函数类型 &&处理) const {
+    constexpr std::size_t 块长 = 256;
+    std::uint64_t 差异[块长];
+    std::uint8_t 命中[块长];
+    for (std::size_t 批号 = 0; 批号 < 批列表.size(); ++批号) {
+      const 角色批 &批 = *批列表[批号];
+      for (std::size_t 起点 = 0; 起点 < 批.大小(); 起点 += 块长) {
+        std::size_t 长度 = std::min(块长, 批.大小() - 起点);
+        std::fill_n(差异, 长度, 0);
+        for (std::size_t 字号 = 0; 字号 < 技能集::字数; ++字号) {
+          std::uint64_t 掩码 = 条件.字[字号];
+          if (掩码 == 0)
+            continue;
+          const std::uint64_t *列 = 批.技能字[字号] + 起点;
+          // 任一: 累积交集, 非零即命中; 全部: 累积缺失位, 为零即命中
+          std::uint64_t 期望 = 方式 == 匹配方式::全部 ? 掩码 : 0;
+          for (std::size_t i = 0; i < 长度; ++i)
+            差异[i] |= (列[i] & 掩码) ^ 期望;
+        }
+        if (方式 == 匹配方式::全部)
+          for (std::size_t i = 0; i < 长度; ++i)
+            命中[i] = 差异[i] == 0;
+        else
+          for (std::size_t i = 0; i < 长度; ++i)
+            命中[i] = 差异[i] != 0;
+        处理(批号, 起点, 命中, 长度);
+      }
+    }
+  }
+};
+
+// 批量生成 数量 个同类角色写入名册, 整批只分配一次内存
+template <角色建造者概念 T>
+角色批 &创建角色批量(角色名册 &名册, std::size_t 数量) {
+  return 名册.追加批(名册.登记原型<T>(), 数量);
+}
@@ -0,0 +1,181 @@
+// 预热子弹枪.h
+// 预热模式: 后台线程提前构造子弹放入每把枪的无锁队列, 射击时直接取出,
+// 把昂贵的构造开销从开火的那一帧挪走; 队列空时退回同步构造
+#pragma once
+
+#include "单生产单消费队列.h"
+#include "工厂示例.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+// 可被后台线程补充的对象
+class 可预热 {
+public:
+  // 补充到上限, 返回本次构造的数量
+  virtual std::size_t 补充() = 0;
+
+protected:
+  ~可预热() = default;
+};
+
+// 子弹预热器: 一个后台线程轮流为所有登记的枪补充子弹
+// 没有补充需求时在原子变量上等待, 枪的队列跌破阈值时唤醒它
+class 子弹预热器 {
+public:
+  子弹预热器() : 工作线程([this](std::stop_token 停止) { 运行(停止); }) {}
+
+  ~子弹预热器() {
+    工作线程.request_stop();
+    唤醒();
+  }
+
+  子弹预热器(const 子弹预热器 &) = delete;
+  子弹预热器 &operator=(const 子弹预热器 &) = delete;
+
+  void 登记(可预热 &目标) {
+    {
+      std::lock_guard 守卫(列表锁);
+      目标列表.push_back(&目标);
+    }
+    唤醒();
+  }
+
+  // 返回后工作线程不会再访问 目标
+  // 只在 目标 自己正被补充时等待这一把枪补充完, 不等其他枪
+  void 注销(可预热 &目标) {
+    std::unique_lock 守卫(列表锁);
+    std::erase(目标列表, &目标);
+    补充完成.wait(守卫, [&] { return 补充中 != &目标; });
+  }
+
+  void 唤醒() {
+    需求序号.fetch_add(1, std::memory_order_release);
+    需求序号.notify_one();
+  }
+
+private:
+  std::mutex 列表锁;
+  std::condition_variable 补充完成;
+  std::vector<可预热 *> 目标列表;
+  可预热 *补充中 = nullptr; // 工作线程正在补充 (锁外) 的目标, 受 列表锁 保护
+  std::atomic<std::uint32_t> 需求序号{0};
+  std::jthread 工作线程; // 最后声明, 最先析构
+
+  void 运行(std::stop_token 停止) {
+    for (;;) {
+      // 先读序号再检查停止: 析构时的 request_stop 先于唤醒, 不会漏掉
+      auto 序号 = 需求序号.load(std::memory_order_acquire);
+      if (停止.stop_requested())
+        return;
+      // 在锁内复制目标列表, 补充 (昂贵的构造) 在锁外进行, 登记和注销不必等整轮补充
+      std::vector<可预热 *> 本轮;
+      {
+        std::lock_guard 守卫(列表锁);
+        本轮 = 目标列表;
+      }
+      std::size_t 产出 = 0;
+      for (可预热 *目标 : 本轮) {
+        {
+          // 复制之后可能已被注销; 仍在列表中才标记为补充中
+          std::lock_guard 守卫(列表锁);
+          if (std::ranges::find(目标列表, 目标) == 目标列表.end())
+            continue;
+          补充中 = 目标;
+        }
+        产出 += 目标->补充();
+        {
+          std::lock_guard 守卫(列表锁);
+          补充中 = nullptr;
+        }
+        补充完成.notify_all();
+      }
+      if (产出 == 0)
+        需求序号.wait(序号, std::memory_order_acquire);
+    }
+  }
+};
+
+// 预热子弹枪: 包装一把 子弹枪, 射击优先从预热队列取子弹
+// 登记在预热器上, 不可移动; 射击只能在同一个线程上调用
+template <std::derived_from<子弹> 子弹类>
+class 预热子弹枪 final : public 枪, private 可预热 {
+public:
+  预热子弹枪(子弹预热器 &预热器, 子弹枪<子弹类> 枪实例,
+             std::size_t 队列容量 = 64)
+      : 预热器(预热器), 枪实例(std::move(枪实例)), 队列(队列容量),
+        补充阈值(队列.最大容量() / 2) {
+    预热器.登记(*this);
+  }
+
+  ~预热子弹枪() override { 预热器.注销(*this); }
+
+  预热子弹枪(const 预热子弹枪 &) = delete;
+  预热子弹枪 &operator=(const 预热子弹枪 &) = delete;
+
+  std::unique_ptr<子弹> 射击() override {
+    射击次数.store(射击次数.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+    auto 预制 = 队列.弹出();
+    if (队列.大小() < 补充阈值)
+      预热器.唤醒();
+    if (预制)
+      return std::move(*预制);
+
+    未命中次数.store(未命中次数.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+    std::lock_guard 守卫(构造锁);
+    return 枪实例.射击();
+  }
+
+  // 以下统计可在任意线程读取
+  std::size_t 队列深度() const { return 队列.大小(); }
+  std::size_t 队列容量() const { return 队列.最大容量(); }
+  std::uint64_t 总射击数() const {
+    return 射击次数.load(std::memory_order_relaxed);
+  }
+  std::uint64_t 未命中数() const {
+    return 未命中次数.load(std::memory_order_relaxed);
+  }
+  double 未命中率() const {
+    auto 总数 = 总射击数();
+    return 总数 ? static_cast<double>(未命中数()) / 总数 : 0.0;
+  }
+
+private:
+  子弹预热器 &预热器;
+  子弹枪<子弹类> 枪实例;
+  // 后台补充与同步回退可能同时构造, 子弹枪 的工厂函数不保证线程安全
+  std::mutex 构造锁;
+  单生产单消费队列<std::unique_ptr<子弹>> 队列;
+  const std::size_t 补充阈值;
+  std::atomic<std::uint64_t> 射击次数{0};
+  std::atomic<std::uint64_t> 未命中次数{0};
+
+  // 在预热器线程上调用; 构造抛出的异常留给同步回退路径重新报告
+  std::size_t 补充() override {
+    std::size_t 产出 = 0;
+    try {
+      while (队列.大小() < 队列.最大容量()) {
+        std::unique_ptr<子弹> 子弹实例;
+        {
+          std::lock_guard 守卫(构造锁);
+          子弹实例 = 枪实例.射击();
+        }
+        if (!队列.压入(子弹实例))
+          break;
+        ++产出;
+      }
+    } catch (...) {
+    }
+    return 产出;
+  }
+};
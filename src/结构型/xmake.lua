@@ -1,7 +1,33 @@
 
 target("适配器模式")
   set_kind("binary")
+  add_includedirs("./", "../../include")
   add_files("./适配器模式.cpp")
+  if is_plat("linux") then
+    add_syslinks("pthread")
+  end
+
+target("适配器模式基准")
+  set_kind("binary")
+  add_includedirs("./", "../../include")
+  add_files("./适配器模式基准.cpp")
+  if is_plat("windows") then
+    add_syslinks("psapi")
+  elseif is_plat("linux") then
+    add_syslinks("pthread")
+  end
+
+-- 同一份基准打开端到端输入延迟统计, 与 适配器模式基准 对比可得到打戳开销
+target("适配器模式延迟基准")
+  set_kind("binary")
+  add_includedirs("./", "../../include")
+  add_defines("启用输入延迟=1")
+  add_files("./适配器模式基准.cpp")
+  if is_plat("windows") then
+    add_syslinks("psapi")
+  elseif is_plat("linux") then
+    add_syslinks("pthread")
+  end
 
 target("桥接模式")
   set_kind("binary")
@@ -0,0 +1,108 @@
+// 输入延迟.h
+// 端到端输入延迟: 设备读取后立即打戳, 戳随采样、事件和快照一路传到动作执行处,
+// 执行时按设备类型记录延迟, 导出 p50/p99/最大值
+// 编译时定义 启用输入延迟=1 才生效; 否则 输入戳 是空类型, 打戳和记录都编译为空操作
+#pragma once
+
+#include "延迟直方图.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <string>
+#include <string_view>
+
+#if !defined(启用输入延迟)
+#define 启用输入延迟 0
+#endif
+
+// 嵌入 输入戳 的成员都加上它, 关闭统计时空的 输入戳 不占空间
+// MSVC 忽略标准的 [[no_unique_address]], 只认自己的 msvc:: 版本
+#if defined(_MSC_VER)
+#define 输入戳不占位 [[msvc::no_unique_address]]
+#else
+#define 输入戳不占位 [[no_unique_address]]
+#endif
+
+enum class 输入设备类型 : std::uint8_t { 未知, 键盘, 手柄, 回放, 数量 };
+
+constexpr std::string_view 设备名称(输入设备类型 类型) {
+  constexpr std::string_view 名称[] = {"未知", "键盘", "手柄", "回放"};
+  return 名称[static_cast<std::size_t>(类型)];
+}
+
+struct 输入戳 {
+#if 启用输入延迟
+  std::uint64_t 纳秒 = 0; // 0 表示没有打戳
+  输入设备类型 来源 = 输入设备类型::未知;
+#endif
+
+  // 在设备读取返回后立即调用
+  static 输入戳 现在([[maybe_unused]] 输入设备类型 来源) {
+#if 启用输入延迟
+    return {static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count()),
+            来源};
+#else
+    return {};
+#endif
+  }
+};
+
+// 每种设备一个直方图; 仅游戏线程使用
+class 输入延迟统计 {
+public:
+  static constexpr bool 启用 = 启用输入延迟;
+
+  // 动作真正执行时调用, 戳来自触发它的快照或事件
+  void 记录执行([[maybe_unused]] 输入戳 戳) {
+#if 启用输入延迟
+    if (戳.纳秒 == 0)
+      return;
+    auto 现在 = 输入戳::现在(戳.来源).纳秒;
+    直方图[static_cast<std::size_t>(戳.来源)].记录(现在 - 戳.纳秒);
+#endif
+  }
+
+  const 延迟直方图 &分布([[maybe_unused]] 输入设备类型 类型) const {
+#if 启用输入延迟
+    return 直方图[static_cast<std::size_t>(类型)];
+#else
+    static const 延迟直方图 空;
+    return 空;
+#endif
+  }
+
+  void 清空() {
+#if 启用输入延迟
+    for (auto &项 : 直方图)
+      项.清空();
+#endif
+  }
+
+  // 每种有记录的设备一行: 设备 次数 p50 p99 最大 (微秒); 未启用时返回空串
+  std::string 导出() const {
+    std::string 结果;
+#if 启用输入延迟
+    for (std::size_t i = 0; i < 直方图.size(); ++i) {
+      const auto &项 = 直方图[i];
+      if (项.次数() == 0)
+        continue;
+      结果 += std::format("{} {} 次 p50 {:.1f} us p99 {:.1f} us 最大 {:.1f} us\n",
+                          设备名称(static_cast<输入设备类型>(i)), 项.次数(),
+                          项.分位数(0.5) / 1e3, 项.分位数(0.99) / 1e3,
+                          项.最大() / 1e3);
+    }
+#endif
+    return 结果;
+  }
+
+#if 启用输入延迟
+private:
+  std::array<延迟直方图, static_cast<std::size_t>(输入设备类型::数量)> 直方图;
+#endif
+};
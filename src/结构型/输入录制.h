@@ -0,0 +1,35 @@
+// 输入录制.h
+// 录制控制器把被包装控制器每帧的动作位写进 输入录像; 回放控制器不限速地把录像读回来
+// 录下一局后即可脱离设备重放整局, 两次运行还能逐帧比较
+#pragma once
+
+#include "输入录像.h"
+#include "输入示例.h"
+
+// 包装任意控制器, 每次轮询原样转发并录下一帧
+// 应每帧只轮询一次 (即只通过 更新() 使用); 配合 输入线程 时录下的是每次采样
+class 录制控制器 : public 游戏控制器 {
+  const 游戏控制器 *被录制;
+  输入录像 *录像;
+
+public:
+  录制控制器(const 游戏控制器 *被录制控制器, 输入录像 *录像目标)
+      : 被录制(被录制控制器), 录像(录像目标) {}
+  输入采样 轮询() const override {
+    输入采样 结果 = 被录制->轮询();
+    录像->追加(结果.动作);
+    return 结果;
+  }
+};
+
+// 按帧回放录像, 没有设备也没有等待; 录像结束后保持最后一帧的动作
+class 回放控制器 : public 游戏控制器 {
+  mutable 输入录像::读取器 读取;
+
+public:
+  explicit 回放控制器(const 输入录像 &录像) : 读取(录像) {}
+  输入采样 轮询() const override {
+    return {读取.下一帧(), 输入戳::现在(输入设备类型::回放)};
+  }
+  bool 结束() const { return 读取.结束(); }
+};
@@ -0,0 +1,172 @@
+// 输入示例.h
+// 输入设备、游戏控制器与适配器; 示例程序与基准共用
+#pragma once
+
+#include "输入延迟.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+class 键盘设备 {
+public:
+  enum 按键 : std::uint32_t { W键 = 1u << 0, J键 = 1u << 1, K键 = 1u << 2 };
+
+  键盘设备() {}
+  ~键盘设备() {}
+  // 一次读出全部按键, 每个键一位; 可以在输入线程中调用
+  std::uint32_t 读取按键() const {
+    return 按键状态.load(std::memory_order_relaxed);
+  }
+  bool W键按下() const { return 读取按键() & W键; }
+  bool J键按下() const { return 读取按键() & J键; }
+  bool K键按下() const { return 读取按键() & K键; }
+
+  // 模拟硬件状态, 供示例和基准驱动
+  void 模拟按键(std::uint32_t 状态) {
+    按键状态.store(状态, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<std::uint32_t> 按键状态{0};
+};
+
+class 手柄设备 {
+public:
+  enum 按钮 : std::uint16_t { A键 = 1u << 0, B键 = 1u << 1 };
+  struct 状态 {
+    float 左摇杆纵向 = 0; // -1 (下) .. 1 (上)
+    std::uint16_t 按钮 = 0;
+  };
+
+  手柄设备() {}
+  ~手柄设备() {}
+  // 一次读出摇杆和全部按钮; 可以在输入线程中调用
+  状态 读取状态() const { return 当前状态.load(std::memory_order_relaxed); }
+  bool 左摇杆上推() const { return 是上推(读取状态()); }
+  bool A键按下() const { return 读取状态().按钮 & A键; }
+  bool B键按下() const { return 读取状态().按钮 & B键; }
+
+  static bool 是上推(const 状态 &采样) { return 采样.左摇杆纵向 > 0.5f; }
+
+  void 模拟状态(状态 新状态) {
+    当前状态.store(新状态, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<状态> 当前状态{状态{}}; // 8 字节, 无锁
+};
+
+// 游戏动作, 每个动作占 动作位 中的一位
+enum class 动作 : std::uint8_t { 向前, 攻击, 跳跃 };
+using 动作位 = std::uint8_t;
+
+constexpr 动作位 位(动作 目标) {
+  return static_cast<动作位>(1u << static_cast<unsigned>(目标));
+}
+
+// 一帧的输入快照: 当前按住的动作, 以及相对上一帧新按下和新松开的动作
+struct 动作快照 {
+  动作位 当前 = 0;
+  动作位 按下 = 0;
+  动作位 松开 = 0;
+  输入戳不占位 输入戳 戳; // 产生本快照的那次设备采样
+
+  bool 按住(动作 目标) const { return 当前 & 位(目标); }
+  bool 刚按下(动作 目标) const { return 按下 & 位(目标); }
+  bool 刚松开(动作 目标) const { return 松开 & 位(目标); }
+};
+static_assert(启用输入延迟 || sizeof(动作快照) == 3 * sizeof(动作位),
+              "关闭输入延迟时 动作快照 不应携带 输入戳");
+
+// 与上一帧异或得到变化的位, 再按本帧/上一帧拆成按下和松开
+constexpr 动作快照 计算边沿(动作位 上一帧, 动作位 本帧) {
+  动作位 变化 = 上一帧 ^ 本帧;
+  return {本帧, static_cast<动作位>(变化 & 本帧),
+          static_cast<动作位>(变化 & 上一帧), {}};
+}
+
+// 大量控制器 (如模拟玩家、回放) 按列存放时一次算完边沿
+// 循环体只有按位运算, 编译器可自动向量化; 结束后 上一帧 更新为 本帧
+inline void 批量计算边沿(std::span<动作位> 上一帧, std::span<const 动作位> 本帧,
+                         std::span<动作位> 按下, std::span<动作位> 松开) {
+  assert(本帧.size() == 上一帧.size() && 按下.size() == 上一帧.size() &&
+         松开.size() == 上一帧.size() && "批量计算边沿: 各列长度不一致");
+  for (std::size_t i = 0; i < 上一帧.size(); ++i) {
+    动作位 变化 = 上一帧[i] ^ 本帧[i];
+    按下[i] = 变化 & 本帧[i];
+    松开[i] = 变化 & 上一帧[i];
+    上一帧[i] = 本帧[i];
+  }
+}
+
+// 一次设备轮询的结果; 未启用输入延迟时只有 动作 一个字节
+struct 输入采样 {
+  动作位 动作 = 0;
+  输入戳不占位 输入戳 戳;
+};
+static_assert(启用输入延迟 || sizeof(输入采样) == sizeof(动作位),
+              "关闭输入延迟时 输入采样 不应携带 输入戳");
+
+// 每帧调用一次 更新(): 适配器只轮询一次设备, 游戏逻辑之后只检查快照中的位
+class 游戏控制器 {
+public:
+  virtual ~游戏控制器() = default;
+
+  // 读取设备当前按住的动作; 只读设备不改快照, 可以在输入线程中调用
+  virtual 输入采样 轮询() const = 0;
+
+  const 动作快照 &更新() { return 更新(轮询()); }
+  // 本帧采样由外部提供 (如输入线程) 时使用
+  const 动作快照 &更新(输入采样 采样) {
+    当前快照 = 计算边沿(当前快照.当前, 采样.动作);
+    当前快照.戳 = 采样.戳;
+    return 当前快照;
+  }
+  const 动作快照 &快照() const { return 当前快照; }
+
+private:
+  动作快照 当前快照;
+};
+
+// 手柄适配器
+class 手柄适配器 : public 游戏控制器 {
+  const 手柄设备 *手柄 = nullptr;
+
+public:
+  手柄适配器(const 手柄设备 *手柄实例) : 手柄(手柄实例) {}
+  输入采样 轮询() const override {
+    手柄设备::状态 采样 = 手柄->读取状态();
+    auto 戳 = 输入戳::现在(输入设备类型::手柄);
+    动作位 结果 = 0;
+    if (手柄设备::是上推(采样))
+      结果 |= 位(动作::向前);
+    if (采样.按钮 & 手柄设备::A键)
+      结果 |= 位(动作::攻击);
+    if (采样.按钮 & 手柄设备::B键)
+      结果 |= 位(动作::跳跃);
+    return {结果, 戳};
+  }
+};
+
+// 键盘适配器
+class 键盘适配器 : public 游戏控制器 {
+  const 键盘设备 *键盘 = nullptr;
+
+public:
+  键盘适配器(const 键盘设备 *键盘实例) : 键盘(键盘实例) {}
+  输入采样 轮询() const override {
+    std::uint32_t 按键 = 键盘->读取按键();
+    auto 戳 = 输入戳::现在(输入设备类型::键盘);
+    动作位 结果 = 0;
+    if (按键 & 键盘设备::W键)
+      结果 |= 位(动作::向前);
+    if (按键 & 键盘设备::J键)
+      结果 |= 位(动作::攻击);
+    if (按键 & 键盘设备::K键)
+      结果 |= 位(动作::跳跃);
+    return {结果, 戳};
+  }
+};
@@ -0,0 +1,108 @@
+// 输入线程.h
+// 专用输入线程按固定间隔轮询适配器, 把带时间戳的输入事件写进无锁环形队列
+// 游戏线程每帧开头取空队列; 设备读取再慢, 也只拖慢输入线程, 不会拖住帧
+#pragma once
+
+#include "单生产单消费队列.h"
+#include "延迟直方图.h"
+#include "输入示例.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct 输入事件 {
+  std::uint64_t 采样纳秒 = 0; // 输入时钟纳秒()
+  std::uint16_t 控制器 = 0;   // 在 输入线程 控制器列表中的下标
+  动作位 动作 = 0;            // 采样时按住的动作
+  输入戳不占位 输入戳 戳; // 设备读取时刻, 供端到端延迟统计
+};
+
+inline std::uint64_t 输入时钟纳秒() {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+// 只在某个控制器的动作变化时产生事件
+// 队列满时这次变化推迟到下一次采样重试, 期间的中间状态可能丢失, 计入 溢出次数
+class 输入线程 {
+public:
+  // 控制器须比 输入线程 活得长; 输入线程只调用它们的 轮询()
+  输入线程(std::vector<游戏控制器 *> 控制器列表,
+           std::chrono::microseconds 采样间隔, std::size_t 队列容量 = 256)
+      : 控制器(std::move(控制器列表)), 队列(队列容量) {
+    if (控制器.size() > UINT16_MAX)
+      throw std::invalid_argument("输入线程: 控制器过多");
+    线程 = std::jthread([this, 采样间隔](std::stop_token 停止) {
+      运行(停止, 采样间隔);
+    });
+  }
+
+  输入线程(const 输入线程 &) = delete;
+  输入线程 &operator=(const 输入线程 &) = delete;
+
+  // 仅游戏线程调用: 按采样先后取出全部事件, 用事件的动作更新对应控制器的快照,
+  // 再调用 处理(事件, 快照); 同一帧内先按下后松开的动作也能逐个看到边沿
+  // 只取读时钟之前已入队的事件, 它们的采样时刻都不晚于 现在; 之后入队的留到下一帧
+  // 返回取出的事件数
+  template <typename 处理函数类型> std::size_t 排空(处理函数类型 &&处理) {
+    const std::size_t 待取 = 队列.大小();
+    const std::uint64_t 现在 = 输入时钟纳秒();
+    for (std::size_t i = 0; i < 待取; ++i) {
+      auto 事件 = 队列.弹出();
+      延迟统计.记录(现在 - 事件->采样纳秒);
+      const 动作快照 &快照 = 控制器[事件->控制器]->更新({事件->动作, 事件->戳});
+      处理(*事件, 快照);
+    }
+    return 待取;
+  }
+
+  std::size_t 排空() {
+    return 排空([](const 输入事件 &, const 动作快照 &) {});
+  }
+
+  // 任意线程可读
+  std::uint64_t 采样次数() const { return 采样.load(std::memory_order_relaxed); }
+  std::uint64_t 溢出次数() const { return 溢出.load(std::memory_order_relaxed); }
+
+  // 从采样到被 排空 取出的纳秒数; 仅游戏线程读取
+  const 延迟直方图 &延迟() const { return 延迟统计; }
+
+private:
+  std::vector<游戏控制器 *> 控制器;
+  单生产单消费队列<输入事件> 队列;
+  延迟直方图 延迟统计;
+  std::atomic<std::uint64_t> 采样{0};
+  std::atomic<std::uint64_t> 溢出{0};
+  std::jthread 线程; // 最后声明, 最先析构: 先停止并等待线程, 再销毁队列
+
+  void 运行(std::stop_token 停止, std::chrono::microseconds 采样间隔) {
+    std::vector<动作位> 已送达(控制器.size(), 0);
+    auto 下次 = std::chrono::steady_clock::now();
+    while (!停止.stop_requested()) {
+      for (std::size_t i = 0; i < 控制器.size(); ++i) {
+        输入采样 采样 = 控制器[i]->轮询();
+        if (采样.动作 == 已送达[i])
+          continue;
+        if (队列.压入(输入事件{输入时钟纳秒(), static_cast<std::uint16_t>(i),
+                               采样.动作, 采样.戳}))
+          已送达[i] = 采样.动作;
+        else
+          溢出.fetch_add(1, std::memory_order_relaxed);
+      }
+      采样.fetch_add(1, std::memory_order_relaxed);
+      // 落后超过一个间隔时不追赶, 从现在重新计时
+      下次 = std::max(下次 + 采样间隔, std::chrono::steady_clock::now());
+      std::this_thread::sleep_until(下次);
+    }
+  }
+};
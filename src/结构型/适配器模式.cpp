@@ -1,73 +1,26 @@
-#include <print>
-
-class 键盘设备 {
-public:
-  键盘设备() {}
-  ~键盘设备() {}
-  bool W键按下() const {
-    std::println("W键按下");
-    return true;
-  }
-  bool J键按下() const {
-    std::println("J键按下");
-    return true;
-  }
-  bool K键按下() const {
-    std::println("K键按下");
-    return true;
-  }
-};
-
-class 手柄设备 {
-public:
-  手柄设备() {}
-  ~手柄设备() {}
-  bool 左摇杆上推() const {
-    std::println("左摇杆上推");
-    return true;
-  }
-  bool A键按下() const {
-    std::println("A键按下");
-    return true;
-  }
-  bool B键按下() const {
-    std::println("B键按下");
-    return true;
-  }
-};
-
-class 游戏控制器 {
-public:
-  virtual bool 向前() = 0;
-  virtual bool 攻击() = 0;
-  virtual bool 跳跃() = 0;
-};
-// 手柄适配器
-class 手柄适配器 : public 游戏控制器 {
-  const 手柄设备 *手柄 = nullptr;
+#include "输入录制.h"
+#include "输入示例.h"
+#include "输入线程.h"
 
-public:
-  手柄适配器(const 手柄设备 *手柄实例) : 手柄(手柄实例) {}
-  bool 向前() override { return 手柄->左摇杆上推(); }
-  bool 攻击() override { return 手柄->A键按下(); }
-  bool 跳跃() override { return 手柄->B键按下(); }
-};
-
-// 键盘适配器
-class 键盘适配器 : public 游戏控制器 {
-  const 键盘设备 *键盘 = nullptr;
+#include <chrono>
+#include <print>
+#include <thread>
 
-public:
-  键盘适配器(const 键盘设备 *键盘实例) : 键盘(键盘实例) {}
-  bool 向前() override { return 键盘->W键按下(); }
-  bool 攻击() override { return 键盘->J键按下(); }
-  bool 跳跃() override { return 键盘->K键按下(); }
-};
+输入延迟统计 延迟统计;
 
+// 每帧只轮询一次设备, 之后的判断都是检查快照中的位
 void 接受输入(游戏控制器 &输入设备) {
-  输入设备.向前();
-  输入设备.攻击();
-  输入设备.跳跃();
+  const 动作快照 &快照 = 输入设备.更新();
+  if (快照.按住(动作::向前))
+    std::println("  向前");
+  if (快照.刚按下(动作::攻击)) {
+    std::println("  攻击 (刚按下)");
+    延迟统计.记录执行(快照.戳); // 动作执行处: 统计从设备读取到此的延迟
+  }
+  if (快照.刚按下(动作::跳跃))
+    std::println("  跳跃 (刚按下)");
+  if (快照.刚松开(动作::跳跃))
+    std::println("  跳跃 (刚松开)");
 }
 
 int main() {
@@ -75,8 +28,50 @@ int main() {
   键盘设备 键盘;
   手柄适配器 手柄输入(&手柄);
   键盘适配器 键盘输入(&键盘);
+  输入录像 键盘录像;
+  录制控制器 录制键盘(&键盘输入, &键盘录像); // 边玩边录
+
+  // 模拟三帧设备状态: 按住前进, 按下再松开跳跃, 第二帧按下攻击
+  const 手柄设备::状态 手柄帧[] = {{1.0f, 手柄设备::B键},
+                                   {1.0f, 手柄设备::A键},
+                                   {0.0f, 0}};
+  const std::uint32_t 键盘帧[] = {键盘设备::W键 | 键盘设备::K键,
+                                  键盘设备::W键 | 键盘设备::J键, 0};
+  for (int 帧 = 0; 帧 < 3; ++帧) {
+    手柄.模拟状态(手柄帧[帧]);
+    键盘.模拟按键(键盘帧[帧]);
+    std::println("第 {} 帧 手柄:", 帧);
+    接受输入(手柄输入);
+    std::println("第 {} 帧 键盘:", 帧);
+    接受输入(录制键盘);
+  }
+
+  // 不接设备, 不限速地重放刚才录下的键盘输入
+  回放控制器 键盘回放(键盘录像);
+  for (int 帧 = 0; !键盘回放.结束(); ++帧) {
+    std::println("回放第 {} 帧 键盘:", 帧);
+    接受输入(键盘回放);
+  }
+  std::println("录像 {} 帧, 编码 {} 字节", 键盘录像.帧数(), 键盘录像.编码字节());
+
+  // 输入线程每 1 ms 采样一次, 游戏线程每帧开头取出期间的事件
+  {
+    输入线程 输入({&手柄输入, &键盘输入}, std::chrono::milliseconds(1));
+    键盘.模拟按键(键盘设备::J键);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    键盘.模拟按键(0);
+    手柄.模拟状态({0.0f, 手柄设备::B键});
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    输入.排空([](const 输入事件 &事件, const 动作快照 &快照) {
+      std::println("输入事件: 控制器 {} 按下 {:03b} 松开 {:03b}", 事件.控制器,
+                   static_cast<unsigned>(快照.按下),
+                   static_cast<unsigned>(快照.松开));
+    });
+    std::println("采样 {} 次, 溢出 {} 次, 最大延迟 {:.2f} ms", 输入.采样次数(),
+                 输入.溢出次数(), 输入.延迟().最大() / 1e6);
+  }
 
-  接受输入(手柄输入);
-  接受输入(键盘输入);
+  if constexpr (输入延迟统计::启用)
+    std::print("端到端输入延迟:\n{}", 延迟统计.导出());
   return 0;
 }
@@ -0,0 +1,439 @@
+// 适配器模式基准.cpp
+// 用法: 适配器模式基准 [基准名]   不带参数时运行全部基准
+// 请在 release 模式下构建: xmake f -m release && xmake run 适配器模式基准
+#include "基准工具.h"
+#include "计数随机数.h"
+#include "输入录制.h"
+#include "输入示例.h"
+#include "输入线程.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <print>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t 控制器数 = 4096;
+constexpr std::size_t 帧数 = 2000;
+
+// 对照: 每个动作一次虚调用, 每次调用都重新读设备
+class 逐动作控制器 {
+public:
+  virtual ~逐动作控制器() = default;
+  virtual bool 向前() = 0;
+  virtual bool 攻击() = 0;
+  virtual bool 跳跃() = 0;
+};
+
+class 逐动作手柄 : public 逐动作控制器 {
+  const 手柄设备 *手柄;
+
+public:
+  explicit 逐动作手柄(const 手柄设备 *手柄实例) : 手柄(手柄实例) {}
+  bool 向前() override { return 手柄->左摇杆上推(); }
+  bool 攻击() override { return 手柄->A键按下(); }
+  bool 跳跃() override { return 手柄->B键按下(); }
+};
+
+class 逐动作键盘 : public 逐动作控制器 {
+  const 键盘设备 *键盘;
+
+public:
+  explicit 逐动作键盘(const 键盘设备 *键盘实例) : 键盘(键盘实例) {}
+  bool 向前() override { return 键盘->W键按下(); }
+  bool 攻击() override { return 键盘->J键按下(); }
+  bool 跳跃() override { return 键盘->K键按下(); }
+};
+
+// 偶数号是手柄, 奇数号是键盘; 每帧约 1/8 的控制器改变按住的动作
+struct 输入场景 {
+  std::vector<动作位> 剧本; // [帧 * 控制器数 + 编号]
+  std::vector<手柄设备> 手柄列表;
+  std::vector<键盘设备> 键盘列表;
+
+  输入场景() : 剧本(帧数 * 控制器数), 手柄列表(控制器数 / 2), 键盘列表(控制器数 / 2) {
+    const auto 密钥 = 计数随机数::派生密钥(22);
+    for (std::size_t 编号 = 0; 编号 < 控制器数; ++编号) {
+      动作位 当前 = 0;
+      for (std::size_t 帧 = 0; 帧 < 帧数; ++帧) {
+        auto 随机 = 计数随机数::生成(帧 * 控制器数 + 编号, 密钥);
+        if ((随机 & 7) == 0)
+          当前 = static_cast<动作位>((随机 >> 3) & 7);
+        剧本[帧 * 控制器数 + 编号] = 当前;
+      }
+    }
+  }
+
+  // 把第 帧 的剧本写进设备, 各方案都要付出同样的开销
+  void 模拟设备(std::size_t 帧) {
+    const 动作位 *本帧 = &剧本[帧 * 控制器数];
+    for (std::size_t 编号 = 0; 编号 < 控制器数; ++编号) {
+      动作位 动作集 = 本帧[编号];
+      if (编号 % 2 == 0) {
+        std::uint16_t 按钮 = 0;
+        if (动作集 & 位(动作::攻击))
+          按钮 |= 手柄设备::A键;
+        if (动作集 & 位(动作::跳跃))
+          按钮 |= 手柄设备::B键;
+        手柄列表[编号 / 2].模拟状态(
+            {动作集 & 位(动作::向前) ? 1.0f : 0.0f, 按钮});
+      } else {
+        std::uint32_t 按键 = 0;
+        if (动作集 & 位(动作::向前))
+          按键 |= 键盘设备::W键;
+        if (动作集 & 位(动作::攻击))
+          按键 |= 键盘设备::J键;
+        if (动作集 & 位(动作::跳跃))
+          按键 |= 键盘设备::K键;
+        键盘列表[编号 / 2].模拟按键(按键);
+      }
+    }
+  }
+};
+
+// 以 "刚按下攻击" 的总次数作为游戏逻辑的消费, 各方案结果必须一致
+void 报告(std::string_view 名称, double 秒, std::uint64_t 攻击次数,
+          std::uint64_t 期望次数) {
+  if (攻击次数 != 期望次数)
+    throw std::logic_error("各方案检测到的按下次数不一致");
+  std::println("  {:<30} {:>8.2f} ms  {:>6.2f} ns/控制器/帧", 名称, 秒 * 1e3,
+               秒 / (帧数 * 控制器数) * 1e9);
+}
+
+void 基准_快照() {
+  std::println("[快照] {} 个控制器 × {} 帧, 统计每帧新按下的攻击", 控制器数,
+               帧数);
+  输入场景 场景;
+
+  std::uint64_t 期望 = 0;
+  {
+    std::vector<动作位> 上一帧(控制器数, 0);
+    for (std::size_t 帧 = 0; 帧 < 帧数; ++帧)
+      for (std::size_t 编号 = 0; 编号 < 控制器数; ++编号) {
+        动作位 本帧 = 场景.剧本[帧 * 控制器数 + 编号];
+        期望 += 计算边沿(上一帧[编号], 本帧).刚按下(动作::攻击);
+        上一帧[编号] = 本帧;
+      }
+  }
+
+  double 仅模拟秒 = 基准计时([&] {
+    for (std::size_t 帧 = 0; 帧 < 帧数; ++帧) {
+      场景.模拟设备(帧);
+      防止优化(场景.手柄列表.data());
+    }
+  });
+  std::println("  (写入模拟设备状态本身 {:.2f} ms, 已计入以下前三项)",
+               仅模拟秒 * 1e3);
+
+  {
+    std::vector<std::unique_ptr<逐动作控制器>> 控制器;
+    for (std::size_t 编号 = 0; 编号 < 控制器数; ++编号) {
+      if (编号 % 2 == 0)
+        控制器.push_back(std::make_unique<逐动作手柄>(&场景.手柄列表[编号 / 2]));
+      else
+        控制器.push_back(std::make_unique<逐动作键盘>(&场景.键盘列表[编号 / 2]));
+    }
+    std::vector<bool> 上次攻击(控制器数, false);
+    std::uint64_t 攻击次数 = 0;
+    double 秒 = 基准计时([&] {
+      for (std::size_t 帧 = 0; 帧 < 帧数; ++帧) {
+        场景.模拟设备(帧);
+        for (std::size_t 编号 = 0; 编号 < 控制器数; ++编号) {
+          auto &项 = *控制器[编号];
+          bool 向前 = 项.向前();
+          bool 攻击 = 项.攻击();
+          bool 跳跃 = 项.跳跃();
+          防止优化(向前);
+          防止优化(跳跃);
+          攻击次数 += 攻击 && !上次攻击[编号];
+          上次攻击[编号] = 攻击;
+        }
+      }
+    });
+    报告("逐动作虚调用 (3 次/帧)", 秒, 攻击次数, 期望);
+  }
+
+  std::vector<std::unique_ptr<游戏控制器>> 控制器;
+  for (std::size_t 编号 = 0; 编号 < 控制器数; ++编号) {
+    if (编号 % 2 == 0)
+      控制器.push_back(std::make_unique<手柄适配器>(&场景.手柄列表[编号 / 2]));
+    else
+      控制器.push_back(std::make_unique<键盘适配器>(&场景.键盘列表[编号 / 2]));
+  }
+
+  {
+    std::uint64_t 攻击次数 = 0;
+    double 秒 = 基准计时([&] {
+      for (std::size_t 帧 = 0; 帧 < 帧数; ++帧) {
+        场景.模拟设备(帧);
+        for (auto &项 : 控制器)
+          攻击次数 += 项->更新().刚按下(动作::攻击);
+      }
+    });
+    报告("快照 更新() (1 次/帧)", 秒, 攻击次数, 期望);
+  }
+
+  std::vector<动作位> 上一帧(控制器数, 0), 本帧(控制器数), 按下(控制器数),
+      松开(控制器数);
+  {
+    std::uint64_t 攻击次数 = 0;
+    double 秒 = 基准计时([&] {
+      for (std::size_t 帧 = 0; 帧 < 帧数; ++帧) {
+        场景.模拟设备(帧);
+        for (std::size_t 编号 = 0; 编号 < 控制器数; ++编号)
+          本帧[编号] = 控制器[编号]->轮询().动作;
+        批量计算边沿(上一帧, 本帧, 按下, 松开);
+        for (动作位 项 : 按下)
+          攻击次数 += (项 >> static_cast<unsigned>(动作::攻击)) & 1;
+      }
+    });
+    报告("轮询 + 批量计算边沿", 秒, 攻击次数, 期望);
+  }
+
+  // 模拟控制器没有设备, 本帧动作直接来自剧本
+  {
+    std::vector<动作快照> 快照(控制器数);
+    std::uint64_t 攻击次数 = 0;
+    double 秒 = 基准计时([&] {
+      for (std::size_t 帧 = 0; 帧 < 帧数; ++帧) {
+        const 动作位 *剧本帧 = &场景.剧本[帧 * 控制器数];
+        for (std::size_t 编号 = 0; 编号 < 控制器数; ++编号) {
+          快照[编号] = 计算边沿(快照[编号].当前, 剧本帧[编号]);
+          攻击次数 += 快照[编号].刚按下(动作::攻击);
+        }
+      }
+    });
+    报告("模拟控制器 逐个计算边沿", 秒, 攻击次数, 期望);
+  }
+  {
+    std::ranges::fill(上一帧, 0);
+    std::uint64_t 攻击次数 = 0;
+    double 秒 = 基准计时([&] {
+      for (std::size_t 帧 = 0; 帧 < 帧数; ++帧) {
+        批量计算边沿(上一帧,
+                     std::span(场景.剧本).subspan(帧 * 控制器数, 控制器数),
+                     按下, 松开);
+        for (动作位 项 : 按下)
+          攻击次数 += (项 >> static_cast<unsigned>(动作::攻击)) & 1;
+      }
+    });
+    报告("模拟控制器 批量计算边沿", 秒, 攻击次数, 期望);
+  }
+}
+
+// 读取一次要阻塞 慢速微秒 的设备, 如经过系统调用或总线的手柄
+class 慢速键盘适配器 : public 键盘适配器 {
+public:
+  慢速键盘适配器(const 键盘设备 *键盘实例, std::chrono::microseconds 阻塞)
+      : 键盘适配器(键盘实例), 阻塞时长(阻塞) {}
+  输入采样 轮询() const override {
+    std::this_thread::sleep_for(阻塞时长);
+    return 键盘适配器::轮询();
+  }
+
+private:
+  std::chrono::microseconds 阻塞时长;
+};
+
+// 模拟一帧的游戏逻辑
+void 忙等(std::chrono::microseconds 时长) {
+  auto 结束 = std::chrono::steady_clock::now() + 时长;
+  while (std::chrono::steady_clock::now() < 结束) {
+  }
+}
+
+void 打印帧时间(std::string_view 名称, const 延迟直方图 &帧时间) {
+  std::println("  {:<22} 帧时间 p50 {:>5.2f} ms  p99 {:>5.2f} ms  最大 {:>5.2f} ms",
+               名称, 帧时间.分位数(0.5) / 1e6, 帧时间.分位数(0.99) / 1e6,
+               帧时间.最大() / 1e6);
+}
+
+void 打印延迟(const 输入线程 &输入) {
+  const auto &延迟 = 输入.延迟();
+  std::println("  {:<22} 输入延迟 p50 {:>5.2f} ms  p99 {:>5.2f} ms  最大 {:>5.2f} ms",
+               "", 延迟.分位数(0.5) / 1e6, 延迟.分位数(0.99) / 1e6,
+               延迟.最大() / 1e6);
+  std::println("  {:<22} 事件 {} 个, 采样 {} 次, 溢出 {} 次", "", 延迟.次数(),
+               输入.采样次数(), 输入.溢出次数());
+}
+
+// 每帧 1 ms 逻辑; 设备读取阻塞 2 ms, 同步轮询时这段阻塞直接落在帧上
+void 基准_输入线程() {
+  using namespace std::chrono_literals;
+  constexpr int 总帧数 = 200;
+  std::println("[输入线程] {} 帧, 每帧逻辑 1 ms, 设备读取阻塞 2 ms", 总帧数);
+  键盘设备 键盘;
+  慢速键盘适配器 控制器(&键盘, 2000us);
+  const std::uint32_t 按键序列[] = {0, 键盘设备::W键, 键盘设备::W键 | 键盘设备::J键,
+                                    键盘设备::J键};
+
+  {
+    延迟直方图 帧时间;
+    for (int 帧 = 0; 帧 < 总帧数; ++帧) {
+      auto 开始 = 输入时钟纳秒();
+      键盘.模拟按键(按键序列[帧 % 4]);
+      防止优化(控制器.更新());
+      忙等(1000us);
+      帧时间.记录(输入时钟纳秒() - 开始);
+    }
+    打印帧时间("同步轮询", 帧时间);
+  }
+  {
+    延迟直方图 帧时间;
+    输入线程 输入({&控制器}, 1000us);
+    for (int 帧 = 0; 帧 < 总帧数; ++帧) {
+      auto 开始 = 输入时钟纳秒();
+      键盘.模拟按键(按键序列[帧 % 4]);
+      输入.排空();
+      防止优化(控制器.快照());
+      忙等(1000us);
+      帧时间.记录(输入时钟纳秒() - 开始);
+    }
+    打印帧时间("输入线程 + 环形队列", 帧时间);
+    打印延迟(输入);
+  }
+
+  // 游戏线程卡顿 20 ms 期间按键变化远多于队列容量, 检查溢出计数
+  {
+    键盘设备 快键盘;
+    键盘适配器 快控制器(&快键盘);
+    输入线程 输入({&快控制器}, 100us, 8);
+    for (int 帧 = 0; 帧 < 10; ++帧) {
+      for (int 次 = 0; 次 < 40; ++次) {
+        快键盘.模拟按键(次 % 2 ? std::uint32_t{键盘设备::J键} : 0u);
+        std::this_thread::sleep_for(500us);
+      }
+      输入.排空();
+    }
+    std::println("  卡顿 20 ms、队列容量 8:");
+    打印延迟(输入);
+  }
+}
+
+// 一局 100 万帧 (60 帧/秒约 4.6 小时) 的键盘输入: 平均每 12 帧换一次按键组合
+void 基准_录像回放() {
+  constexpr std::uint64_t 局帧数 = 1'000'000;
+  std::println("[录像回放] {} 帧", 局帧数);
+  键盘设备 键盘;
+  键盘适配器 键盘输入(&键盘);
+  输入录像 录像;
+  录制控制器 录制(&键盘输入, &录像);
+  const auto 密钥 = 计数随机数::派生密钥(24);
+
+  std::uint64_t 攻击次数 = 0;
+  double 录制秒 = 基准计时([&] {
+    std::uint32_t 按键 = 0;
+    for (std::uint64_t 帧 = 0; 帧 < 局帧数; ++帧) {
+      auto 随机 = 计数随机数::生成(帧, 密钥);
+      if (随机 % 12 == 0)
+        按键 = (随机 >> 8) & 7;
+      键盘.模拟按键(按键);
+      攻击次数 += 录制.更新().刚按下(动作::攻击);
+    }
+  });
+
+  auto 文件 = std::filesystem::temp_directory_path() / "适配器模式基准.录像";
+  double 保存秒 = 基准计时([&] { 录像.保存(文件); });
+  输入录像 载入录像;
+  double 载入秒 = 基准计时([&] { 载入录像 = 输入录像::载入(文件); });
+  std::filesystem::remove(文件);
+
+  std::uint64_t 回放攻击次数 = 0;
+  double 回放秒 = 基准计时([&] {
+    回放控制器 回放(载入录像);
+    while (!回放.结束())
+      回放攻击次数 += 回放.更新().刚按下(动作::攻击);
+  });
+  if (回放攻击次数 != 攻击次数 || 输入录像::首个差异帧(录像, 载入录像))
+    throw std::logic_error("回放与录制不一致");
+
+  std::println("  编码 {} 字节 (每帧 1 字节时 {} 字节, 压缩到 {:.1f}%)",
+               录像.编码字节(), 局帧数,
+               100.0 * 录像.编码字节() / 局帧数);
+  std::println("  录制 {:>7.2f} ms  {:>5.2f} ns/帧 (含模拟设备)", 录制秒 * 1e3,
+               录制秒 / 局帧数 * 1e9);
+  std::println("  保存 {:>7.2f} ms  载入并校验 {:.2f} ms", 保存秒 * 1e3,
+               载入秒 * 1e3);
+  std::println("  回放 {:>7.2f} ms  {:>5.2f} ns/帧, 约 {:.0f} 倍实时 (60 帧/秒)",
+               回放秒 * 1e3, 回放秒 / 局帧数 * 1e9, 局帧数 / 60.0 / 回放秒);
+}
+
+// 键盘和手柄经输入线程 (1 ms 采样), 每帧排空后跑 2 ms 逻辑再执行刚按下的攻击
+// 延迟 = 设备读取 -> 动作执行, 含在队列中等待和本帧逻辑的时间
+void 基准_输入延迟() {
+  using namespace std::chrono_literals;
+  constexpr int 总帧数 = 300;
+  std::println("[输入延迟] {} 帧, 每帧逻辑 2 ms", 总帧数);
+  if constexpr (!输入延迟统计::启用) {
+    std::println("  未启用; 请构建 适配器模式延迟基准 (定义了 启用输入延迟=1)");
+    return;
+  }
+  键盘设备 键盘;
+  手柄设备 手柄;
+  键盘适配器 键盘输入(&键盘);
+  手柄适配器 手柄输入(&手柄);
+  输入延迟统计 统计;
+
+  {
+    输入线程 输入({&键盘输入, &手柄输入}, 1000us);
+    for (int 帧 = 0; 帧 < 总帧数; ++帧) {
+      键盘.模拟按键(帧 % 2 ? std::uint32_t{键盘设备::J键} : 0u);
+      手柄.模拟状态({0.0f, static_cast<std::uint16_t>(帧 % 3 ? 0 : 手柄设备::A键)});
+      std::vector<输入戳> 待执行;
+      输入.排空([&](const 输入事件 &, const 动作快照 &快照) {
+        if (快照.刚按下(动作::攻击))
+          待执行.push_back(快照.戳);
+      });
+      忙等(2000us);
+      for (输入戳 戳 : 待执行)
+        统计.记录执行(戳);
+    }
+  }
+  std::print("  输入线程:\n{}", 统计.导出());
+
+  统计.清空();
+  for (int 帧 = 0; 帧 < 总帧数; ++帧) {
+    键盘.模拟按键(帧 % 2 ? std::uint32_t{键盘设备::J键} : 0u);
+    手柄.模拟状态({0.0f, static_cast<std::uint16_t>(帧 % 3 ? 0 : 手柄设备::A键)});
+    const 动作快照 键盘快照 = 键盘输入.更新();
+    const 动作快照 手柄快照 = 手柄输入.更新();
+    忙等(2000us);
+    if (键盘快照.刚按下(动作::攻击))
+      统计.记录执行(键盘快照.戳);
+    if (手柄快照.刚按下(动作::攻击))
+      统计.记录执行(手柄快照.戳);
+  }
+  std::print("  帧开头同步轮询:\n{}", 统计.导出());
+}
+
+struct 基准项 {
+  std::string_view 名称;
+  void (*函数)();
+};
+
+constexpr 基准项 全部基准[] = {
+    {"快照", 基准_快照},
+    {"输入线程", 基准_输入线程},
+    {"录像回放", 基准_录像回放},
+    {"输入延迟", 基准_输入延迟},
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string_view 选择 = argc > 1 ? argv[1] : "";
+  for (const auto &项 : 全部基准) {
+    if (选择.empty() || 选择 == 项.名称)
+      项.函数();
+  }
+  return 0;
+}
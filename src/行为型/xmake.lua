@@ -5,6 +5,7 @@ target("责任链模式")
 
 target("命令模式")
   set_kind("binary")
+  add_includedirs("../../include")
   add_files("./命令模式.cpp")
 
 target("迭代器模式")
@@ -47,7 +48,7 @@ target("解释器模式")
     set_kind("binary")
     add_files("解释器模式.cpp")
     add_deps("lua库")
-    add_includedirs("../../lib/lua-5.4.7/src")
+    add_includedirs("../../lib/lua-5.4.7/src", "../../include")
     -- add_defines("LUA_UCID") -- 定义宏,支持Unicode标识符
     -- 将脚本文件复制到输出目录
     after_build(function (target)
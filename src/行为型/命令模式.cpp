@@ -1,8 +1,14 @@
+#include "输入录像.h"
+
+#include <cstdint>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <print> // C++23 标准打印头文件
 #include <stack>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -182,7 +188,28 @@ private:
   std::unordered_map<char, std::shared_ptr<命令>> 按键映射;
 };
 
-int main() {
+// 用法: 命令模式 [--录制 <文件> | --回放 <文件>]
+// 录制时把每次读到的按键逐个写进输入录像; 回放时不再读标准输入, 不等待地重放
+int main(int argc, char *argv[]) {
+  std::string_view 模式 = argc > 1 ? argv[1] : "";
+  bool 参数有效 =
+      argc == 1 || (argc == 3 && (模式 == "--录制" || 模式 == "--回放"));
+  if (!参数有效) {
+    std::println("用法: 命令模式 [--录制 <文件> | --回放 <文件>]");
+    return 1;
+  }
+  输入录像 录像;
+  std::optional<输入录像::读取器> 回放;
+  if (模式 == "--回放") {
+    try {
+      录像 = 输入录像::载入(argv[2]);
+    } catch (const std::exception &错误) {
+      std::println("载入输入录像失败: {}", 错误.what());
+      return 1;
+    }
+    回放.emplace(录像);
+  }
+
   // 创建游戏角色
   游戏角色 角色;
 
@@ -220,9 +247,18 @@ int main() {
   char 按键;
 
   while (true) {
-    std::println(
-        "\n输入按键 (w/a/s/d移动, j攻击, k跳跃, m连招, u撤销, r重做, q退出):");
-    std::cin >> 按键;
+    if (回放) {
+      if (回放->结束())
+        break;
+      按键 = static_cast<char>(回放->下一帧());
+    } else {
+      std::println(
+          "\n输入按键 (w/a/s/d移动, j攻击, k跳跃, m连招, u撤销, r重做, q退出):");
+      if (!(std::cin >> 按键))
+        break;
+      if (模式 == "--录制")
+        录像.追加(static_cast<std::uint8_t>(按键));
+    }
 
     if (按键 == 'q')
       break;
@@ -242,5 +278,14 @@ int main() {
     角色.显示位置();
   }
 
+  if (模式 == "--录制") {
+    try {
+      录像.保存(argv[2]);
+      std::println("已录制 {} 次按键到 {}", 录像.帧数(), argv[2]);
+    } catch (const std::exception &错误) {
+      std::println("保存输入录像失败: {}", 错误.what());
+      return 1;
+    }
+  }
   std::println("游戏结束");
 }
@@ -1,13 +1,18 @@
+#include <cstdint>
+#include <ctime>
 #include <fcntl.h>
 #include <filesystem>
 #include <iostream>
 #include <lua.hpp>
 #include <string>
 
+#include "计数随机数.h"
+
 // 游戏脚本解释器类
 class 游戏脚本解释器 {
 public:
-  游戏脚本解释器() {
+  // 每个解释器拥有独立的随机流, 相同种子得到相同的伤害序列
+  explicit 游戏脚本解释器(std::uint64_t 随机种子 = 0) : 随机数(随机种子) {
     lua状态 = luaL_newstate();
     luaL_openlibs(lua状态);
   }
@@ -45,6 +50,18 @@ public:
     lua_register(lua状态, 函数名.c_str(), 函数指针);
   }
 
+  // 注册需要访问本解释器随机流的C++函数, 随机流作为上值传入
+  void 注册随机函数(const std::string &函数名, lua_CFunction 函数指针) {
+    lua_pushlightuserdata(lua状态, &随机数);
+    lua_pushcclosure(lua状态, 函数指针, 1);
+    lua_setglobal(lua状态, 函数名.c_str());
+  }
+
+  // 供随机函数取回所属解释器的随机流
+  static 计数随机数 &取随机流(lua_State *L) {
+    return *static_cast<计数随机数 *>(lua_touserdata(L, lua_upvalueindex(1)));
+  }
+
   // 清理Lua状态
   void 清理() {
     if (lua状态) {
@@ -55,6 +72,7 @@ public:
 
 private:
   lua_State *lua状态;
+  计数随机数 随机数;
 };
 
 // 计算玩家伤害的C++函数，将被绑定到Lua
@@ -65,7 +83,7 @@ static int 计算伤害(lua_State *L) {
 
   // 简单伤害计算逻辑：基础攻击力 + 暴击判断
   int 伤害 = 攻击力;
-  if (rand() % 100 < 暴击率) {
+  if (游戏脚本解释器::取随机流(L).范围(0, 100) < 暴击率) {
     伤害 = 攻击力 * (100 + 暴击伤害) / 100;
     lua_pushstring(L, "暴击! 造成");
   } else {
@@ -77,13 +95,11 @@ static int 计算伤害(lua_State *L) {
 }
 
 int main() {
-  // 基本控制台设置
-  srand(time(nullptr)); // 初始化随机数种子
-
-  游戏脚本解释器 解释器;
+  // 以当前时间为随机种子; 传入固定种子即可复现同一局的伤害序列
+  游戏脚本解释器 解释器(static_cast<std::uint64_t>(time(nullptr)));
 
   // 注册C++函数到Lua
-  解释器.注册函数("计算伤害", 计算伤害);
+  解释器.注册随机函数("计算伤害", 计算伤害);
 
   // 从文件执行游戏相关的Lua代码
   std::string 脚本路径 = "game_script.lua"; // 使用相对路径